@@ -0,0 +1,89 @@
+// Copyright (c) 2020 The TecraCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "arith_uint256.h"
+#include "bls/bls_worker.h"
+
+#include <cassert>
+
+struct DKGQuorum
+{
+    BLSIdVector ids;
+    std::vector<BLSVerificationVectorPtr> vvecs;
+    // contributions received by the first member, one per contributor
+    BLSSecretKeyVector receivedSkContributions;
+};
+
+static void BuildQuorum(CBLSWorker& worker, size_t quorumIndex, size_t size, size_t threshold, DKGQuorum& quorum)
+{
+    for (size_t i = 0; i < size; i++) {
+        quorum.ids.emplace_back(CBLSId::FromHash(ArithToUint256(arith_uint256(quorumIndex * size + i + 1))));
+    }
+    for (size_t i = 0; i < size; i++) {
+        BLSVerificationVectorPtr vvec;
+        BLSSecretKeyVector skShares;
+        bool fGenerated = worker.GenerateContributions((int)threshold, quorum.ids, vvec, skShares);
+        assert(fGenerated);
+        quorum.vvecs.emplace_back(vvec);
+        quorum.receivedSkContributions.emplace_back(skShares[0]);
+    }
+}
+
+// One iteration is the contribution verification of one member in each of several concurrent quorums, all of them
+// sharing one CBLSWorker. Comparing the worker counts shows how well DKG phases of multiple LLMQs overlap
+static void VerifyContributions(benchmark::State& state, int workerCount)
+{
+    const size_t quorumCount = 4;
+    const size_t quorumSize = 50;
+    const size_t quorumThreshold = 30;
+
+    CBLSWorker worker;
+    worker.Start(workerCount);
+
+    std::vector<DKGQuorum> quorums(quorumCount);
+    for (size_t i = 0; i < quorumCount; i++) {
+        BuildQuorum(worker, i, quorumSize, quorumThreshold, quorums[i]);
+    }
+
+    while (state.KeepRunning()) {
+        std::vector<std::future<std::vector<bool>>> futures;
+        for (const auto& quorum : quorums) {
+            futures.emplace_back(worker.AsyncVerifyContributionShares(quorum.ids[0], quorum.vvecs, quorum.receivedSkContributions, true, true));
+        }
+        for (auto& f : futures) {
+            for (bool valid : f.get()) {
+                assert(valid);
+            }
+        }
+    }
+
+    worker.Stop();
+}
+
+static void BLSDKGVerifyContributions_1Thread(benchmark::State& state)
+{
+    VerifyContributions(state, 1);
+}
+
+static void BLSDKGVerifyContributions_2Threads(benchmark::State& state)
+{
+    VerifyContributions(state, 2);
+}
+
+static void BLSDKGVerifyContributions_4Threads(benchmark::State& state)
+{
+    VerifyContributions(state, 4);
+}
+
+static void BLSDKGVerifyContributions_8Threads(benchmark::State& state)
+{
+    VerifyContributions(state, 8);
+}
+
+BENCHMARK(BLSDKGVerifyContributions_1Thread);
+BENCHMARK(BLSDKGVerifyContributions_2Threads);
+BENCHMARK(BLSDKGVerifyContributions_4Threads);
+BENCHMARK(BLSDKGVerifyContributions_8Threads);
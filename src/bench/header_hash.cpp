@@ -0,0 +1,62 @@
+// Copyright (c) 2020 The TecraCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "primitives/block.h"
+
+// Number of headers hashed per iteration, roughly one "headers" message
+static const int HEADERS_PER_ITERATION = 100;
+
+static CBlockHeader MakeHeader(uint32_t nNonce)
+{
+    CBlockHeader header;
+    header.nVersion = 0x20000002;
+    header.hashMerkleRoot = uint256S("0x6c7a7d5e3ec1d5ba2c8da6c46ee2b1f7a9e9ffdab4ce3ba4b8f1c2d3e4f5a6b7");
+    header.nTime = 1500000000;
+    header.nBits = 0x1e0ffff0;
+    header.nNonce = nNonce;
+    return header;
+}
+
+// Full Lyra2Z on every header: what every GetHash() call used to cost
+static void HeaderHashLyra2Z(benchmark::State& state)
+{
+    uint32_t nNonce = 0;
+    while (state.KeepRunning()) {
+        for (int i = 0; i < HEADERS_PER_ITERATION; i++)
+            MakeHeader(nNonce++).GetHash();
+    }
+}
+
+// Repeated GetHash() on copies of an already hashed header (per-object memo)
+static void HeaderHashCopyCached(benchmark::State& state)
+{
+    CBlockHeader header = MakeHeader(0);
+    header.GetHash();
+    while (state.KeepRunning()) {
+        for (int i = 0; i < HEADERS_PER_ITERATION; i++) {
+            CBlockHeader copy = header;
+            copy.GetHash();
+        }
+    }
+}
+
+// Same header rebuilt from its fields, as when it is received again from another peer
+static void HeaderHashRebuiltCached(benchmark::State& state)
+{
+    std::vector<CBlockHeader> headers;
+    for (int i = 0; i < HEADERS_PER_ITERATION; i++) {
+        headers.push_back(MakeHeader(i));
+        headers.back().GetHash();
+    }
+    while (state.KeepRunning()) {
+        for (int i = 0; i < HEADERS_PER_ITERATION; i++)
+            MakeHeader(i).GetHash();
+    }
+}
+
+BENCHMARK(HeaderHashLyra2Z);
+BENCHMARK(HeaderHashCopyCached);
+BENCHMARK(HeaderHashRebuiltCached);
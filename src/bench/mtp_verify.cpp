@@ -0,0 +1,31 @@
+// Copyright (c) 2020 The TecraCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "crypto/MerkleTreeProof/mtp.h"
+#include "primitives/block.h"
+
+// One iteration verifies the MTP proof of one block, so iterations per second
+// is the number of blocks per second that block connection and -reindex can check.
+static void MTPVerifyBlock(benchmark::State& state)
+{
+    uint256 powLimit = uint256S("00ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff");
+
+    CBlockHeader header;
+    header.nVersion = 0x20000002;
+    header.hashPrevBlock = uint256S("0x7fda1abdca0f11c3cad5f67e73d8485922e256a194a92290b00085515df464dd");
+    header.hashMerkleRoot = uint256S("0x1de29eeb5446230c0a17eb841159d41ac0636c5218c8efaf780b96cfca948854");
+    header.nTime = 1500000000;
+    header.nBits = 0x2000ffff;
+    header.nVersionMTP = 0x1000;
+    // Building the Argon2 matrix and Merkle tree is expensive, do it once
+    header.mtpHashValue = mtp::hash(header, powLimit);
+
+    while (state.KeepRunning()) {
+        assert(mtp::verify(header.nNonce, header, powLimit));
+    }
+}
+
+BENCHMARK(MTPVerifyBlock);
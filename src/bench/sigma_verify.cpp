@@ -0,0 +1,66 @@
+// Copyright (c) 2020 The TecraCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "sigma/params.h"
+#include "sigma/sigmaplus_prover.h"
+#include "sigma/sigmaplus_verifier.h"
+
+#include <cassert>
+
+typedef sigma::SigmaPlusProof<Scalar, GroupElement> Proof;
+
+// Build a proof of membership in a full anonymity set with the default parameters
+static void CreateProof(const sigma::Params *params, std::vector<GroupElement>& commits, Proof& proof)
+{
+    const std::size_t N = params->get_n();
+    const std::size_t m = params->get_m();
+    std::size_t setSize = 1;
+    for (std::size_t i = 0; i < m; ++i)
+        setSize *= N;
+
+    commits.resize(setSize);
+    for (auto& c : commits)
+        c.randomize();
+
+    std::size_t index = setSize / 3;
+    Scalar r;
+    r.randomize();
+    commits[index] = sigma::SigmaPrimitives<Scalar, GroupElement>::commit(params->get_g(), Scalar(uint64_t(0)), params->get_h0(), r);
+
+    sigma::SigmaPlusProver<Scalar, GroupElement> prover(params->get_g(), params->get_h(), N, m);
+    prover.proof(commits, index, r, true, proof);
+}
+
+// One iteration verifies one sigma spend proof, so iterations per second is the
+// number of spends per second that block connection can check one at a time.
+static void VerifyProof(benchmark::State& state, bool fPrecomputed)
+{
+    const sigma::Params *params = sigma::Params::get_default();
+    std::vector<GroupElement> commits;
+    Proof proof(params->get_n(), params->get_m());
+    CreateProof(params, commits, proof);
+
+    sigma::SigmaPlusVerifier<Scalar, GroupElement> verifier(
+        params->get_g(), params->get_h(), params->get_n(), params->get_m(),
+        fPrecomputed ? &params->get_gens_table() : nullptr);
+
+    while (state.KeepRunning()) {
+        assert(verifier.verify(commits, proof, true));
+    }
+}
+
+static void SigmaVerifyProof(benchmark::State& state)
+{
+    VerifyProof(state, false);
+}
+
+static void SigmaVerifyProofPrecomputed(benchmark::State& state)
+{
+    VerifyProof(state, true);
+}
+
+BENCHMARK(SigmaVerifyProof);
+BENCHMARK(SigmaVerifyProofPrecomputed);
@@ -215,6 +215,32 @@ CBLSPublicKey CBLSPublicKey::AggregateInsecure(const std::vector<CBLSPublicKey>&
     return ret;
 }
 
+CBLSPublicKey CBLSPublicKey::AggregateSecure(const std::vector<CBLSPublicKey>& pks)
+{
+    if (pks.empty()) {
+        return CBLSPublicKey();
+    }
+
+    std::vector<bls::PublicKey> v;
+    v.reserve(pks.size());
+    for (auto& pk : pks) {
+        if (!pk.IsValid()) {
+            return CBLSPublicKey();
+        }
+        v.emplace_back(pk.impl);
+    }
+
+    CBLSPublicKey ret;
+    try {
+        ret.impl = bls::PublicKey::Aggregate(v);
+        ret.fValid = true;
+    } catch (...) {
+        ret.fValid = false;
+    }
+    ret.UpdateHash();
+    return ret;
+}
+
 bool CBLSPublicKey::PublicKeyShare(const std::vector<CBLSPublicKey>& mpk, const CBLSId& _id)
 {
     fValid = false;
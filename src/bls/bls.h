@@ -274,6 +274,9 @@ public:
 
     void AggregateInsecure(const CBLSPublicKey& o);
     static CBLSPublicKey AggregateInsecure(const std::vector<CBLSPublicKey>& pks);
+    // Aggregates with the same per key exponents as CBLSSignature::VerifySecureAggregated, so that a securely
+    // aggregated signature of a single message can be verified (or batch verified) against the returned key
+    static CBLSPublicKey AggregateSecure(const std::vector<CBLSPublicKey>& pks);
 
     bool PublicKeyShare(const std::vector<CBLSPublicKey>& mpk, const CBLSId& id);
     bool DHKeyExchange(const CBLSSecretKey& sk, const CBLSPublicKey& pk);
@@ -58,10 +58,12 @@ CBLSWorker::~CBLSWorker()
     Stop();
 }
 
-void CBLSWorker::Start()
+void CBLSWorker::Start(int workerCount)
 {
-    int workerCount = std::thread::hardware_concurrency() / 2;
-    workerCount = std::max(std::min(1, workerCount), 4);
+    if (workerCount <= 0) {
+        // never less than 4 threads, small masternode hosts rely on them for DKG and sig share verification
+        workerCount = std::max(4, (int)std::thread::hardware_concurrency() / 2);
+    }
     workerPool.resize(workerCount);
     RenameThreadPool(workerPool, "dash-bls-worker");
 }
@@ -70,6 +72,7 @@ void CBLSWorker::Stop()
 {
     workerPool.clear_queue();
     workerPool.stop(true);
+    stopped = true;
 }
 
 bool CBLSWorker::GenerateContributions(int quorumThreshold, const BLSIdVector& ids, BLSVerificationVectorPtr& vvecRet, BLSSecretKeyVector& skShares)
@@ -9,6 +9,8 @@
 
 #include "ctpl.h"
 
+#include <atomic>
+#include <chrono>
 #include <future>
 #include <mutex>
 
@@ -49,13 +51,30 @@ private:
     int sigVerifyBatchesInProgress{0};
     std::vector<SigVerifyJob> sigVerifyQueue;
 
+    std::atomic<bool> stopped{false};
+
 public:
     CBLSWorker();
     ~CBLSWorker();
 
-    void Start();
+    // workerCount <= 0 uses half of the available cores, but at least 4 threads
+    void Start(int workerCount = 0);
     void Stop();
 
+    // Waits until a future completed by the worker is ready. Stop() drops all queued work, so futures of dropped work
+    // never get ready. Returns false if the worker was stopped before the future got ready, in which case no worker
+    // thread will touch the inputs of that work anymore
+    template <typename T>
+    bool WaitForResult(const std::future<T>& f) const
+    {
+        while (f.wait_for(std::chrono::milliseconds(100)) != std::future_status::ready) {
+            if (stopped) {
+                return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+            }
+        }
+        return true;
+    }
+
     bool GenerateContributions(int threshold, const BLSIdVector& ids, BLSVerificationVectorPtr& vvecRet, BLSSecretKeyVector& skShares);
 
     // The following functions are all used to aggregate verification (public key) vectors
@@ -111,6 +111,33 @@ const CBlockIndex* CBlockIndex::GetAncestor(int height) const
     return const_cast<CBlockIndex*>(this)->GetAncestor(height);
 }
 
+bool (*ReadBlockPrivacyData)(const uint256& hash, CBlockPrivacyData& data) = nullptr;
+
+const CBlockPrivacyData& CBlockIndex::GetPrivacyData() const
+{
+    static const CBlockPrivacyData emptyData;
+
+    if (!privacyData && fPrivacyDataOnDisk) {
+        std::shared_ptr<CBlockPrivacyData> data = std::make_shared<CBlockPrivacyData>();
+        if (!ReadBlockPrivacyData || !ReadBlockPrivacyData(GetBlockHash(), *data))
+            throw std::runtime_error(strprintf("%s: failed to read privacy data of block %s", __func__, GetBlockHash().ToString()));
+        privacyData = data;
+        fPrivacyDataOnDisk = false;
+    }
+    return privacyData ? *privacyData : emptyData;
+}
+
+CBlockPrivacyData& CBlockIndex::GetPrivacyDataForUpdate()
+{
+    GetPrivacyData();
+    if (!privacyData)
+        privacyData = std::make_shared<CBlockPrivacyData>();
+    else if (privacyData.use_count() > 1)
+        // shared with a copy of this index, e.g. a CDiskBlockIndex being written
+        privacyData = std::make_shared<CBlockPrivacyData>(*privacyData);
+    return *privacyData;
+}
+
 void CBlockIndex::BuildSkip()
 {
     if (pprev)
@@ -21,6 +21,7 @@
 #include "coin_containers.h"
 #include "streams.h"
 
+#include <memory>
 #include <vector>
 #include <unordered_set>
 
@@ -159,8 +160,58 @@ enum BlockStatus: uint32_t {
     BLOCK_FAILED_MASK        =   BLOCK_FAILED_VALID | BLOCK_FAILED_CHILD,
 
     BLOCK_OPT_WITNESS       =   128, //!< block data in blk*.data was received with a witness-enforcing client
+
+    BLOCK_HAVE_PRIVACY_DATA =   256, //!< (on disk only) zerocoin/sigma data of the block is in the privacy index
 };
 
+/** Zerocoin and sigma mints and spends of a block. Few blocks have any, so CBlockIndex
+ * only allocates them for blocks that do and they are stored apart from the block index.
+ */
+class CBlockPrivacyData
+{
+public:
+    //! Public coin values of mints in this block, ordered by serialized value of public coin
+    //! Maps <denomination,id> to vector of public coins
+    map<pair<int,int>, vector<CBigNum>> mintedPubCoins;
+
+    //! Accumulator updates. Contains only changes made by mints in this block
+    //! Maps <denomination, id> to <accumulator value (CBigNum), number of such mints in this block>
+    map<pair<int,int>, pair<CBigNum,int>> accumulatorChanges;
+
+    //! (memory only) Same as accumulatorChanges but for alternative modulus
+    map<pair<int,int>, pair<CBigNum,int>> alternativeAccumulatorChanges;
+
+    //! Values of coin serials spent in this block
+    set<CBigNum> spentSerials;
+
+    //! Public coin values of sigma mints in this block, ordered by serialized value of public coin
+    //! Maps <denomination,id> to vector of public coins
+    std::map<pair<sigma::CoinDenomination, int>, vector<sigma::PublicCoin>> sigmaMintedPubCoins;
+
+    //! Values of sigma coin serials spent in this block
+    sigma::spend_info_container sigmaSpentSerials;
+
+    bool IsEmpty() const
+    {
+        return mintedPubCoins.empty() && accumulatorChanges.empty() && alternativeAccumulatorChanges.empty() &&
+            spentSerials.empty() && sigmaMintedPubCoins.empty() && sigmaSpentSerials.empty();
+    }
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(mintedPubCoins);
+        READWRITE(accumulatorChanges);
+        READWRITE(spentSerials);
+        READWRITE(sigmaMintedPubCoins);
+        READWRITE(sigmaSpentSerials);
+    }
+};
+
+/** Reads the privacy data of a block from the privacy index, set by the block tree database */
+extern bool (*ReadBlockPrivacyData)(const uint256& hash, CBlockPrivacyData& data);
+
 /** The block chain is a tree shaped structure starting with the
  * genesis block at the root, with each block potentially having multiple
  * candidates to be the next block. A blockindex may have multiple pprev pointing
@@ -224,28 +275,14 @@ public:
     //! (memory only) Maximum nTime in the chain upto and including this block.
     unsigned int nTimeMax;
 
-    //! Public coin values of mints in this block, ordered by serialized value of public coin
-    //! Maps <denomination,id> to vector of public coins
-    map<pair<int,int>, vector<CBigNum>> mintedPubCoins;
-
-    //! Accumulator updates. Contains only changes made by mints in this block
-    //! Maps <denomination, id> to <accumulator value (CBigNum), number of such mints in this block>
-    map<pair<int,int>, pair<CBigNum,int>> accumulatorChanges;
-
-	//! Same as accumulatorChanges but for alternative modulus
-	map<pair<int,int>, pair<CBigNum,int>> alternativeAccumulatorChanges;
-
-    //! Values of coin serials spent in this block
-	set<CBigNum> spentSerials;
-
-/////////////////////// Sigma index entries. ////////////////////////////////////////////
+private:
+    //! Zerocoin and sigma data, null if the block has none or it isn't loaded yet
+    mutable std::shared_ptr<CBlockPrivacyData> privacyData;
 
-    //! Public coin values of mints in this block, ordered by serialized value of public coin
-    //! Maps <denomination,id> to vector of public coins
-    std::map<pair<sigma::CoinDenomination, int>, vector<sigma::PublicCoin>> sigmaMintedPubCoins;
+    //! Whether the privacy index has data for this block which isn't loaded yet
+    mutable bool fPrivacyDataOnDisk;
 
-    //! Values of coin serials spent in this block
-    sigma::spend_info_container sigmaSpentSerials;
+public:
 
     void SetNull()
     {
@@ -272,11 +309,8 @@ public:
         nVersionMTP = 0;
         mtpHashValue = reserved[0] = reserved[1] = uint256();
 
-        mintedPubCoins.clear();
-        sigmaMintedPubCoins.clear();
-        accumulatorChanges.clear();
-        spentSerials.clear();
-        sigmaSpentSerials.clear();
+        privacyData.reset();
+        fPrivacyDataOnDisk = false;
     }
 
     CBlockIndex()
@@ -338,6 +372,9 @@ public:
             block.reserved[0] = reserved[0];
             block.reserved[1] = reserved[1];
 		}
+        // The index key is the hash of exactly this header, no need to run Lyra2Z again
+        if (phashBlock)
+            block.SetCachedHash(*phashBlock);
         return block;
     }
 
@@ -408,6 +445,29 @@ public:
         return false;
     }
 
+    //! Zerocoin and sigma data of the block, read from the privacy index when first used.
+    //! Callers hold cs_main
+    const CBlockPrivacyData& GetPrivacyData() const;
+
+    //! Same as GetPrivacyData(), to change the data. Allocates it for blocks without any
+    CBlockPrivacyData& GetPrivacyDataForUpdate();
+
+    //! Whether the block has zerocoin or sigma data, without loading it
+    bool HasPrivacyData() const
+    {
+        return privacyData ? !privacyData->IsEmpty() : fPrivacyDataOnDisk;
+    }
+
+    //! Whether the data is loaded and may differ from the privacy index
+    bool IsPrivacyDataLoaded() const { return privacyData != nullptr; }
+
+    //! Note that the privacy index has data for this block, it is read when first used
+    void SetPrivacyDataOnDisk()
+    {
+        privacyData.reset();
+        fPrivacyDataOnDisk = true;
+    }
+
     //! Build the skiplist pointer for this entry.
     void BuildSkip();
 
@@ -436,8 +496,15 @@ public:
     explicit CDiskBlockIndex(const CBlockIndex* pindex) : CBlockIndex(*pindex) {
         hashPrev = (pprev ? pprev->GetBlockHash() : uint256());
         nDiskBlockVersion = 0;
+        if (pindex->HasPrivacyData())
+            nStatus |= BLOCK_HAVE_PRIVACY_DATA;
+        else
+            nStatus &= ~BLOCK_HAVE_PRIVACY_DATA;
     }
 
+    //! Privacy data stored in the entry itself by older versions, to be moved to the privacy index
+    std::shared_ptr<CBlockPrivacyData> legacyPrivacyData;
+
     ADD_SERIALIZE_METHODS;
 
     template <typename Stream, typename Operation>
@@ -472,17 +539,23 @@ public:
             READWRITE(reserved[1]);
         }
 
+        // Zerocoin and sigma data used to be stored here, it is in the privacy index now
+        // and the maps written here are empty
+        CBlockPrivacyData inlineData;
         if (!(s.GetType() & SER_GETHASH) && nVersion >= ZC_ADVANCED_INDEX_VERSION) {
-            READWRITE(mintedPubCoins);
-		    READWRITE(accumulatorChanges);
-            READWRITE(spentSerials);
-	    }
+            READWRITE(inlineData.mintedPubCoins);
+            READWRITE(inlineData.accumulatorChanges);
+            READWRITE(inlineData.spentSerials);
+        }
 
         if (!(s.GetType() & SER_GETHASH) && nHeight >= Params().GetConsensus().nSigmaStartBlock) {
-            READWRITE(sigmaMintedPubCoins);
-            READWRITE(sigmaSpentSerials);
+            READWRITE(inlineData.sigmaMintedPubCoins);
+            READWRITE(inlineData.sigmaSpentSerials);
         }
 
+        if (ser_action.ForRead() && !inlineData.IsEmpty())
+            legacyPrivacyData = std::make_shared<CBlockPrivacyData>(std::move(inlineData));
+
         nDiskBlockVersion = nVersion;
     }
 
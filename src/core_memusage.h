@@ -51,11 +51,18 @@ static inline size_t RecursiveDynamicUsage(const CMutableTransaction& tx) {
     return mem;
 }
 
+static inline size_t RecursiveDynamicUsage(const CMTPHashData& mtpHashData) {
+    return memusage::DynamicUsage(mtpHashData.nProofMTP.GetNodes());
+}
+
 static inline size_t RecursiveDynamicUsage(const CBlock& block) {
     size_t mem = memusage::DynamicUsage(block.vtx);
     for (const auto& tx : block.vtx) {
         mem += memusage::DynamicUsage(tx) + RecursiveDynamicUsage(*tx);
     }
+    if (block.mtpHashData) {
+        mem += memusage::DynamicUsage(block.mtpHashData) + RecursiveDynamicUsage(*block.mtpHashData);
+    }
     return mem;
 }
 
@@ -58,9 +58,7 @@ MerkleTree::Buffer MerkleTree::hash(const Buffer& data)
 {
     blake2b_state state;
     blake2b_init(&state, MERKLE_TREE_ELEMENT_SIZE_B);
-    for (Buffer::const_iterator it = data.begin(); it != data.end(); ++it) {
-        blake2b_4r_update(&state, &(*it), sizeof(*it));
-    }
+    blake2b_4r_update(&state, data.data(), data.size());
     uint8_t digest[MERKLE_TREE_ELEMENT_SIZE_B];
     blake2b_4r_final(&state, digest, sizeof(digest));
     return Buffer(digest, digest + sizeof(digest));
@@ -192,6 +190,38 @@ bool MerkleTree::checkProofOrdered(const Elements& proof,
     return tempHash == root;
 }
 
+bool MerkleTree::checkProofOrdered(const uint8_t *proof, size_t proofSize,
+        const uint8_t *root, const uint8_t *element, size_t index)
+{
+    --index; // `index` argument starts at 1
+    uint8_t buffer[MERKLE_TREE_ELEMENT_SIZE_B * 2];
+    uint8_t tempHash[MERKLE_TREE_ELEMENT_SIZE_B];
+    std::copy(element, element + MERKLE_TREE_ELEMENT_SIZE_B, tempHash);
+    for (size_t i = 0; i < proofSize; ++i) {
+        size_t remaining = proofSize - i;
+        const uint8_t *node = proof + i * MERKLE_TREE_ELEMENT_SIZE_B;
+
+        // See above
+        while (((index & 1) == 0) && (index >= (1u << remaining))) {
+            index = index / 2;
+        }
+
+        if (index & 1) {
+            std::copy(node, node + MERKLE_TREE_ELEMENT_SIZE_B, buffer);
+            std::copy(tempHash, tempHash + MERKLE_TREE_ELEMENT_SIZE_B, buffer + MERKLE_TREE_ELEMENT_SIZE_B);
+        } else {
+            std::copy(tempHash, tempHash + MERKLE_TREE_ELEMENT_SIZE_B, buffer);
+            std::copy(node, node + MERKLE_TREE_ELEMENT_SIZE_B, buffer + MERKLE_TREE_ELEMENT_SIZE_B);
+        }
+        blake2b_state state;
+        blake2b_init(&state, MERKLE_TREE_ELEMENT_SIZE_B);
+        blake2b_4r_update(&state, buffer, sizeof(buffer));
+        blake2b_4r_final(&state, tempHash, sizeof(tempHash));
+        index = index / 2;
+    }
+    return std::equal(tempHash, tempHash + MERKLE_TREE_ELEMENT_SIZE_B, root);
+}
+
 void MerkleTree::getLayers()
 {
     layers_.clear();
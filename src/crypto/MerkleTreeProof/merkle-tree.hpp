@@ -199,6 +199,22 @@ public :
     static bool checkProofOrdered(const Elements& proof, const Buffer& root,
             const Buffer& element, size_t index);
 
+    /** Check a proof stored as contiguous nodes in a Merkle Tree with order preserved
+     *
+     * Same as above for a proof of `proofSize` hashes stored back to back,
+     * the proof is read in place without copying it.
+     *
+     * \param proof     [in] `proofSize` * `MERKLE_TREE_ELEMENT_SIZE_B` bytes
+     * \param proofSize [in] Number of hashes in `proof`
+     * \param root      [in] Root hash of the Merke Tree
+     * \param element   [in] Element for which the proof is checked
+     * \param index     [in] Index of above element, starting at 1
+     *
+     * \return `true` if `proof` is valid, `false` if not
+     */
+    static bool checkProofOrdered(const uint8_t *proof, size_t proofSize,
+            const uint8_t *root, const uint8_t *element, size_t index);
+
 private :
     /** Layers data structure
      *
@@ -19,8 +19,15 @@ extern "C" {
 #include "merkle-tree.hpp"
 #include "primitives/block.h"
 #include "streams.h"
-#include <boost/multiprecision/cpp_int.hpp>
+#include "libzerocoin/ParallelTasks.h"
+#include <atomic>
+#include <functional>
 #include <boost/numeric/conversion/cast.hpp>
+#include <boost/thread.hpp>
+
+#ifndef WIN32
+#include <sys/mman.h> // for mmap
+#endif
 
 using boost::numeric_cast;
 using boost::numeric::bad_numeric_cast;
@@ -40,6 +47,14 @@ const unsigned T_COST = 1;
 const unsigned M_COST = 1024 * 1024 * 4;
 const unsigned LANES = 4;
 
+static_assert((M_COST & (M_COST - 1)) == 0, "GetOpeningIndex() relies on M_COST being a power of two");
+
+/** Index of the block opened at a step: y interpreted as a 256-bit number modulo M_COST */
+uint32_t GetOpeningIndex(const uint256& y)
+{
+    return numeric_cast<uint32_t>(UintToArith256(y).GetLow64() % M_COST);
+}
+
 void StoreBlock(void *output, const block *src)
 {
     for (unsigned i = 0; i < ARGON2_QWORDS_IN_BLOCK; ++i) {
@@ -189,6 +204,21 @@ void compute_blake2b(const block& input,
     clear_internal_memory(tmp_block_bytes, ARGON2_BLOCK_SIZE);
 }
 
+/** Merkle opening to be checked once the whole chain of steps has been recomputed */
+struct OpeningCheck
+{
+    const uint8_t *proof;
+    size_t proofSize;
+    uint8_t digest[MERKLE_TREE_ELEMENT_SIZE_B];
+    size_t index;
+    const char *name;
+
+    bool Check(const uint8_t root[MERKLE_TREE_ELEMENT_SIZE_B]) const
+    {
+        return MerkleTree::checkProofOrdered(proof, proofSize, root, digest, index);
+    }
+};
+
 struct TargetHelper
 {
     bool m_negative;
@@ -209,11 +239,10 @@ namespace impl
 bool mtp_verify(const char* input, const uint32_t target,
         const uint8_t hash_root_mtp[16], uint32_t nonce,
         const uint64_t block_mtp[MTP_L*2][128],
-        const std::deque<std::vector<uint8_t>> proof_mtp[MTP_L*3],
+        const ProofSet& proof_mtp,
         uint256 pow_limit,
         uint256 *mtpHashValue)
 {
-    MerkleTree::Buffer const root(&hash_root_mtp[0], &hash_root_mtp[16]);
     block blocks[L * 2];
     for(int i = 0; i < (L * 2); ++i) {
         std::memcpy(blocks[i].v, block_mtp[i],
@@ -295,11 +324,12 @@ bool mtp_verify(const char* input, const uint32_t target,
     initial_hash(h0, &context_verify, instance.type);
     
     // step 8
+    // The chain of y values only depends on the blocks supplied with the proof, so the
+    // Merkle openings are collected here and checked in parallel once the chain is done
+    OpeningCheck openings[L * 3];
     for (uint32_t j = 1; j <= L; ++j) {
         // compute ij
-        std::string s = "0x" + y[j - 1].GetHex();
-        boost::multiprecision::uint256_t t(s);
-        uint32_t ij = numeric_cast<uint32_t>(t % M_COST);
+        uint32_t ij = GetOpeningIndex(y[j - 1]);
 
         // retrieve x[ij-1] and x[phi(i)] from proof
         block prev_block, ref_block, t_prev_block, t_ref_block;
@@ -332,15 +362,12 @@ bool mtp_verify(const char* input, const uint32_t target,
         }
 
         //hash[prev_index]
-        uint8_t digest_prev[MERKLE_TREE_ELEMENT_SIZE_B];
-        compute_blake2b(prev_block, digest_prev);
-        MerkleTree::Buffer hash_prev(digest_prev,
-                digest_prev + sizeof(digest_prev));
-        if (!MerkleTree::checkProofOrdered(proof_mtp[(j * 3) - 2],
-                    root, hash_prev, ij_prev + 1)) {
-            LogPrintf("error : checkProofOrdered in x[ij_prev]\n");
-            return false;
-        }
+        OpeningCheck& check_prev = openings[(j * 3) - 2];
+        compute_blake2b(prev_block, check_prev.digest);
+        check_prev.proof = proof_mtp.GetProof((j * 3) - 2);
+        check_prev.proofSize = proof_mtp.GetProofSize((j * 3) - 2);
+        check_prev.index = ij_prev + 1;
+        check_prev.name = "x[ij_prev]";
 
         //compute ref_index
         uint64_t prev_block_opening = prev_block.v[0];
@@ -364,14 +391,12 @@ bool mtp_verify(const char* input, const uint32_t target,
 
         uint32_t computed_ref_block = (lane_length * ref_lane) + ref_index;
 
-        uint8_t digest_ref[MERKLE_TREE_ELEMENT_SIZE_B];
-        compute_blake2b(ref_block, digest_ref);
-        MerkleTree::Buffer hash_ref(digest_ref, digest_ref + sizeof(digest_ref));
-        if (!MerkleTree::checkProofOrdered(proof_mtp[(j * 3) - 1],
-                    root, hash_ref, computed_ref_block + 1)) {
-            LogPrintf("error : checkProofOrdered in x[ij_ref]\n");
-            return false;
-        }
+        OpeningCheck& check_ref = openings[(j * 3) - 1];
+        compute_blake2b(ref_block, check_ref.digest);
+        check_ref.proof = proof_mtp.GetProof((j * 3) - 1);
+        check_ref.proofSize = proof_mtp.GetProofSize((j * 3) - 1);
+        check_ref.index = computed_ref_block + 1;
+        check_ref.name = "x[ij_ref]";
 
         // compute x[ij]
         block block_ij;
@@ -380,15 +405,12 @@ bool mtp_verify(const char* input, const uint32_t target,
 
         // verify opening
         // hash x[ij]
-        uint8_t digest_ij[MERKLE_TREE_ELEMENT_SIZE_B];
-        compute_blake2b(block_ij, digest_ij);
-        MerkleTree::Buffer hash_ij(digest_ij, digest_ij + sizeof(digest_ij));
-
-        if (!MerkleTree::checkProofOrdered(proof_mtp[(j * 3) - 3], root,
-                    hash_ij, ij + 1)) {
-            LogPrintf("error : checkProofOrdered in x[ij]\n");
-            return false;
-        }
+        OpeningCheck& check_ij = openings[(j * 3) - 3];
+        compute_blake2b(block_ij, check_ij.digest);
+        check_ij.proof = proof_mtp.GetProof((j * 3) - 3);
+        check_ij.proofSize = proof_mtp.GetProofSize((j * 3) - 3);
+        check_ij.index = ij + 1;
+        check_ij.name = "x[ij]";
 
         // compute y(j)
         block blockhash;
@@ -405,6 +427,27 @@ bool mtp_verify(const char* input, const uint32_t target,
         clear_internal_memory(blockhash_bytes, ARGON2_BLOCK_SIZE);
     }    
 
+    {
+        libzerocoin::ParallelTasks::DoNotDisturb dnd;
+        libzerocoin::ParallelTasks tasks(L);
+        // one task per step, each checking the three openings of that step
+        char openingValid[L * 3];
+        for (int j = 0; j < L; ++j) {
+            tasks.Add([&openings, &openingValid, hash_root_mtp, j]() {
+                for (int k = j * 3; k < (j + 1) * 3; ++k)
+                    openingValid[k] = openings[k].Check(hash_root_mtp);
+            });
+        }
+        tasks.Wait();
+
+        for (int k = 0; k < L * 3; ++k) {
+            if (!openingValid[k]) {
+                LogPrintf("error : checkProofOrdered in %s\n", openings[k].name);
+                return false;
+            }
+        }
+    }
+
     // step 9
     bool negative;
     bool overflow;
@@ -428,10 +471,81 @@ bool mtp_verify(const char* input, const uint32_t target,
 
 namespace {
 
+/** Arena serving the Argon2 allocation of the current thread, argon2_context callbacks carry no user data */
+thread_local MemoryArena *currentArena = nullptr;
+
+int ArenaAllocate(uint8_t **memory, size_t bytes_to_allocate)
+{
+    *memory = currentArena->Reserve(bytes_to_allocate);
+    return *memory ? ARGON2_OK : ARGON2_MEMORY_ALLOCATION_ERROR;
+}
+
+void ArenaFree(uint8_t *memory, size_t bytes_to_allocate)
+{
+    // the memory stays with the arena for the next block template
+}
+
+/** Steps 4 to 6 for a single nonce: only the chain of y values, without collecting blocks and proofs
+ *
+ * \return `true` if the nonce avoids the first two blocks of every lane and meets the target
+ */
+bool TryNonce(const char* input, const uint8_t hash_root_mtp[16],
+        uint32_t nonce, const argon2_instance_t& instance,
+        TargetHelper const& bn_target, uint256 const& pow_limit)
+{
+    uint256 y;
+    blake2b_state state;
+    blake2b_init(&state, 32); // 256 bit
+    blake2b_update(&state, input, 80);
+    blake2b_update(&state, hash_root_mtp, MERKLE_TREE_ELEMENT_SIZE_B);
+    blake2b_update(&state, &nonce, sizeof(unsigned int));
+    blake2b_final(&state, &y, sizeof(uint256));
+
+    uint32_t const except_index = numeric_cast<uint32_t>(M_COST / LANES);
+    uint8_t blockhash_bytes[ARGON2_BLOCK_SIZE];
+    for (uint32_t j = 1; j <= L; ++j) {
+        uint32_t ij = GetOpeningIndex(y);
+        if (((ij % except_index) == 0) || ((ij % except_index) == 1)) {
+            return false;
+        }
+
+        StoreBlock(&blockhash_bytes, &instance.memory[ij]);
+        blake2b_state ctx_yj;
+        blake2b_init(&ctx_yj, 32);
+        blake2b_update(&ctx_yj, &y, 32);
+        blake2b_update(&ctx_yj, blockhash_bytes, ARGON2_BLOCK_SIZE);
+        blake2b_final(&ctx_yj, &y, 32);
+    }
+    clear_internal_memory(blockhash_bytes, ARGON2_BLOCK_SIZE);
+
+    return !(bn_target.m_negative || (bn_target.m_target == 0) || bn_target.m_overflow
+            || (bn_target.m_target > UintToArith256(pow_limit))
+            || (UintToArith256(y) > bn_target.m_target));
+}
+
+/** Run `task(thread index)` on `nThreads` threads including the calling one */
+void RunOnThreads(unsigned int nThreads, std::function<void(unsigned int)> task)
+{
+    boost::thread_group threads;
+    for (unsigned int t = 1; t < nThreads; ++t)
+        threads.create_thread(std::bind(task, t));
+
+    // the workers reference the caller's stack, never leave before they are done
+    try {
+        task(0);
+    } catch (...) {
+        boost::this_thread::disable_interruption di;
+        threads.join_all();
+        throw;
+    }
+    boost::this_thread::disable_interruption di;
+    threads.join_all();
+}
+
 bool mtp_hash1(const char* input, uint32_t target, uint8_t hash_root_mtp[16],
         unsigned int& nonce, uint64_t block_mtp[MTP_L*2][128],
-        std::deque<std::vector<uint8_t>> proof_mtp[MTP_L*3], uint256 pow_limit,
-        uint256& output)
+        ProofSet& proof_mtp, uint256 pow_limit,
+        uint256& output, MemoryArena *arena, unsigned int nThreads)
 {
 #define TEST_OUTLEN 32
 #define TEST_PWDLEN 80
@@ -471,6 +585,15 @@ bool mtp_hash1(const char* input, uint32_t target, uint8_t hash_root_mtp[16],
 #undef TEST_SECRETLEN
 #undef TEST_ADLEN
 
+    if (arena) {
+        currentArena = arena;
+        context.allocate_cbk = ArenaAllocate;
+        context.free_cbk = ArenaFree;
+    }
+    if (nThreads < 1) {
+        nThreads = 1;
+    }
+
     uint32_t memory_blocks = context.m_cost;
     if (memory_blocks < (2 * ARGON2_SYNC_POINTS * context.lanes)) {
         memory_blocks = 2 * ARGON2_SYNC_POINTS * context.lanes;
@@ -493,121 +616,139 @@ bool mtp_hash1(const char* input, uint32_t target, uint8_t hash_root_mtp[16],
     }
 
     // step 1
-    Argon2CtxMtp(&context, Argon2_d, &instance);
+    if (Argon2CtxMtp(&context, Argon2_d, &instance) != ARGON2_OK) {
+        throw std::runtime_error("mtp_hash: unable to fill the Argon2 memory");
+    }
+
+    // releases the Argon2 memory (a no-op when it is owned by the arena) on every way out
+    struct MemoryGuard {
+        argon2_context& context;
+        argon2_instance_t& instance;
+        ~MemoryGuard() {
+            if (!context.free_cbk)
+                free_memory(&context, (uint8_t *)instance.memory, instance.memory_blocks, sizeof(block));
+        }
+    } memoryGuard{context, instance};
 
     // step 2
-    MerkleTree::Elements elements;
-    for (long int i = 0; i < instance.memory_blocks; ++i) {
-        uint8_t digest[MERKLE_TREE_ELEMENT_SIZE_B];
-        compute_blake2b(instance.memory[i], digest);
-        elements.emplace_back(digest, digest + sizeof(digest));
-    }
+    MerkleTree::Elements elements(instance.memory_blocks);
+    RunOnThreads(nThreads, [&](unsigned int t) {
+        for (long int i = t; i < instance.memory_blocks; i += nThreads) {
+            uint8_t digest[MERKLE_TREE_ELEMENT_SIZE_B];
+            compute_blake2b(instance.memory[i], digest);
+            elements[i].assign(digest, digest + sizeof(digest));
+        }
+    });
 
     MerkleTree ordered_tree(elements, true);
+    MerkleTree::Elements().swap(elements);
     MerkleTree::Buffer root = ordered_tree.getRoot();
     std::copy(root.begin(), root.end(), hash_root_mtp);
 
     // step 3
-    unsigned int n_nonce_internal = 0;
     TargetHelper const bn_target(target);
 
-    // step 4
+    // steps 4 to 6: every thread walks its own residue class of nonces and stops at the
+    // best nonce found so far, so the result is the smallest valid nonce as in a serial search
+    std::atomic<uint32_t> best_nonce(UINT_MAX);
+    std::atomic<bool> interrupted(false);
+    RunOnThreads(nThreads, [&](unsigned int t) {
+        for (uint32_t n = t; n < best_nonce.load(std::memory_order_relaxed); n += nThreads) {
+            // only the calling thread can be interrupted (e.g. the miner thread on shutdown)
+            if (t == 0 && (n & 0xff) == 0 && boost::this_thread::interruption_requested()) {
+                interrupted = true;
+            }
+            if (interrupted) {
+                break;
+            }
+            if (TryNonce(input, hash_root_mtp, n, instance, bn_target, pow_limit)) {
+                uint32_t current = best_nonce.load();
+                while (n < current && !best_nonce.compare_exchange_weak(current, n)) {}
+                break;
+            }
+            if (n > UINT_MAX - nThreads) {
+                break;
+            }
+        }
+    });
+
+    if (interrupted) {
+        boost::this_thread::interruption_point();
+    }
+
+    if (best_nonce.load() == UINT_MAX) {
+        // go to create a new merkle tree
+        return false;
+    }
+    unsigned int n_nonce_internal = best_nonce.load();
+
+    // collect the blocks and proofs for the winning nonce
     uint256 y[L + 1];
     block blocks[L * 2];
     MerkleTree::Elements proof_blocks[L * 3];
-    while (true) {
-        if (n_nonce_internal == UINT_MAX) {
-            // go to create a new merkle tree
-            return false;
-        }
 
-        std::memset(&y[0], 0, sizeof(y));
-        std::memset(&blocks[0], 0, sizeof(sizeof(block) * L * 2));
-
-        blake2b_state state;
-        blake2b_init(&state, 32); // 256 bit
-        blake2b_update(&state, input, 80);
-        blake2b_update(&state, hash_root_mtp, MERKLE_TREE_ELEMENT_SIZE_B);
-        blake2b_update(&state, &n_nonce_internal, sizeof(unsigned int));
-        blake2b_final(&state, &y[0], sizeof(uint256));
-
-        // step 5
-        bool init_blocks = false;
-        for (uint32_t j = 1; j <= L; ++j) {
-            std::string s = "0x" + y[j - 1].GetHex();
-            boost::multiprecision::uint256_t t(s);
-            uint32_t ij = numeric_cast<uint32_t>(t % M_COST);
-            uint32_t except_index = numeric_cast<uint32_t>(M_COST / LANES);
-            if (((ij % except_index) == 0) || ((ij % except_index) == 1)) {
-                init_blocks = true;
-                break;
-            }
+    std::memset(&y[0], 0, sizeof(y));
+    std::memset(&blocks[0], 0, sizeof(sizeof(block) * L * 2));
 
-            block blockhash;
-            copy_block(&blockhash, &instance.memory[ij]);
-            uint8_t blockhash_bytes[ARGON2_BLOCK_SIZE];
-            StoreBlock(&blockhash_bytes, &blockhash);
-            blake2b_state ctx_yj;
-            blake2b_init(&ctx_yj, 32);
-            blake2b_update(&ctx_yj, &y[j - 1], 32);
-            blake2b_update(&ctx_yj, blockhash_bytes, ARGON2_BLOCK_SIZE);
-            blake2b_final(&ctx_yj, &y[j], 32);
-            clear_internal_memory(blockhash.v, ARGON2_BLOCK_SIZE);
-            clear_internal_memory(blockhash_bytes, ARGON2_BLOCK_SIZE);
-
-            //storing blocks
-            uint32_t prev_index;
-            uint32_t ref_index;
-            GetBlockIndex(ij, &instance, &prev_index, &ref_index);
-            //previous block
-            copy_block(&blocks[(j * 2) - 2], &instance.memory[prev_index]);
-            //ref block
-            copy_block(&blocks[(j * 2) - 1], &instance.memory[ref_index]);
-
-            //storing proof
-            //TODO : make it as function please
-            //current proof
-            uint8_t digest_curr[MERKLE_TREE_ELEMENT_SIZE_B];
-            compute_blake2b(instance.memory[ij], digest_curr);
-            MerkleTree::Buffer hash_curr(digest_curr,
-                    digest_curr + sizeof(digest_curr));
-            MerkleTree::Elements proof_curr = ordered_tree.getProofOrdered(
-                    hash_curr, ij + 1);
-            proof_blocks[(j * 3) - 3] = proof_curr;
-
-            //prev proof
-            uint8_t digest_prev[MERKLE_TREE_ELEMENT_SIZE_B];
-            compute_blake2b(instance.memory[prev_index], digest_prev);
-            MerkleTree::Buffer hash_prev(digest_prev,
-                    digest_prev + sizeof(digest_prev));
-            MerkleTree::Elements proof_prev = ordered_tree.getProofOrdered(
-                    hash_prev, prev_index + 1);
-            proof_blocks[(j * 3) - 2] = proof_prev;
-
-            //ref proof
-            uint8_t digest_ref[MERKLE_TREE_ELEMENT_SIZE_B];
-            compute_blake2b(instance.memory[ref_index], digest_ref);
-            MerkleTree::Buffer hash_ref(digest_ref,
-                    digest_ref + sizeof(digest_ref));
-            MerkleTree::Elements proof_ref = ordered_tree.getProofOrdered(
-                    hash_ref, ref_index + 1);
-            proof_blocks[(j * 3) - 1] = proof_ref;
-        }
+    blake2b_state state;
+    blake2b_init(&state, 32); // 256 bit
+    blake2b_update(&state, input, 80);
+    blake2b_update(&state, hash_root_mtp, MERKLE_TREE_ELEMENT_SIZE_B);
+    blake2b_update(&state, &n_nonce_internal, sizeof(unsigned int));
+    blake2b_final(&state, &y[0], sizeof(uint256));
 
-        if (init_blocks) {
-            n_nonce_internal++;
-            continue;
-        }
+    for (uint32_t j = 1; j <= L; ++j) {
+        uint32_t ij = GetOpeningIndex(y[j - 1]);
 
-        // step 6
-        if (bn_target.m_negative || (bn_target.m_target == 0) || bn_target.m_overflow
-                || (bn_target.m_target > UintToArith256(pow_limit))
-                || (UintToArith256(y[L]) > bn_target.m_target)) {
-            n_nonce_internal++;
-            continue;
-        }
+        block blockhash;
+        copy_block(&blockhash, &instance.memory[ij]);
+        uint8_t blockhash_bytes[ARGON2_BLOCK_SIZE];
+        StoreBlock(&blockhash_bytes, &blockhash);
+        blake2b_state ctx_yj;
+        blake2b_init(&ctx_yj, 32);
+        blake2b_update(&ctx_yj, &y[j - 1], 32);
+        blake2b_update(&ctx_yj, blockhash_bytes, ARGON2_BLOCK_SIZE);
+        blake2b_final(&ctx_yj, &y[j], 32);
+        clear_internal_memory(blockhash.v, ARGON2_BLOCK_SIZE);
+        clear_internal_memory(blockhash_bytes, ARGON2_BLOCK_SIZE);
 
-        break;
+        //storing blocks
+        uint32_t prev_index;
+        uint32_t ref_index;
+        GetBlockIndex(ij, &instance, &prev_index, &ref_index);
+        //previous block
+        copy_block(&blocks[(j * 2) - 2], &instance.memory[prev_index]);
+        //ref block
+        copy_block(&blocks[(j * 2) - 1], &instance.memory[ref_index]);
+
+        //storing proof
+        //TODO : make it as function please
+        //current proof
+        uint8_t digest_curr[MERKLE_TREE_ELEMENT_SIZE_B];
+        compute_blake2b(instance.memory[ij], digest_curr);
+        MerkleTree::Buffer hash_curr(digest_curr,
+                digest_curr + sizeof(digest_curr));
+        MerkleTree::Elements proof_curr = ordered_tree.getProofOrdered(
+                hash_curr, ij + 1);
+        proof_blocks[(j * 3) - 3] = proof_curr;
+
+        //prev proof
+        uint8_t digest_prev[MERKLE_TREE_ELEMENT_SIZE_B];
+        compute_blake2b(instance.memory[prev_index], digest_prev);
+        MerkleTree::Buffer hash_prev(digest_prev,
+                digest_prev + sizeof(digest_prev));
+        MerkleTree::Elements proof_prev = ordered_tree.getProofOrdered(
+                hash_prev, prev_index + 1);
+        proof_blocks[(j * 3) - 2] = proof_prev;
+
+        //ref proof
+        uint8_t digest_ref[MERKLE_TREE_ELEMENT_SIZE_B];
+        compute_blake2b(instance.memory[ref_index], digest_ref);
+        MerkleTree::Buffer hash_ref(digest_ref,
+                digest_ref + sizeof(digest_ref));
+        MerkleTree::Elements proof_ref = ordered_tree.getProofOrdered(
+                hash_ref, ref_index + 1);
+        proof_blocks[(j * 3) - 1] = proof_ref;
     }
 
     // step 7
@@ -618,20 +759,16 @@ bool mtp_hash1(const char* input, uint32_t target, uint8_t hash_root_mtp[16],
         std::memcpy(block_mtp[i], &blocks[i],
                 sizeof(uint64_t) * ARGON2_QWORDS_IN_BLOCK);
     }
+    proof_mtp.Clear();
     for (int i = 0; i < L * 3; ++i) {
-        proof_mtp[i] = proof_blocks[i];
+        uint8_t *nodes = proof_mtp.AppendProof(proof_blocks[i].size());
+        for (const MerkleTree::Buffer& node : proof_blocks[i]) {
+            std::copy(node.begin(), node.end(), nodes);
+            nodes += ProofSet::NODE_SIZE;
+        }
     }
     std::memcpy(&output, &y[L], sizeof(uint256));
 
-    uint8_t h0[ARGON2_PREHASH_SEED_LENGTH];
-    std::memcpy(h0, instance.hash_zero,
-            sizeof(uint8_t) * ARGON2_PREHASH_SEED_LENGTH);
-
-    // get hash_zero
-    uint8_t h0_computed[ARGON2_PREHASH_SEED_LENGTH];
-    initial_hash(h0_computed, &context, instance.type);
-    
-    free_memory(&context, (uint8_t *)instance.memory, instance.memory_blocks, sizeof(block));
     return true;
 }
 
@@ -639,18 +776,73 @@ bool mtp_hash1(const char* input, uint32_t target, uint8_t hash_root_mtp[16],
 
 void mtp_hash(const char* input, uint32_t target, uint8_t hash_root_mtp[16],
         unsigned int& nonce, uint64_t block_mtp[MTP_L*2][128],
-        std::deque<std::vector<uint8_t>> proof_mtp[MTP_L*3], uint256 pow_limit,
-        uint256& output)
+        ProofSet& proof_mtp, uint256 pow_limit,
+        uint256& output, MemoryArena *arena, unsigned int nThreads)
 {
     bool done = false;
     while (!done) {
         done = mtp_hash1(input, target, hash_root_mtp, nonce, block_mtp,
-                proof_mtp, pow_limit, output);
+                proof_mtp, pow_limit, output, arena, nThreads);
     }
 }
 
 }
 
+MemoryArena::MemoryArena() : memory(nullptr), size(0) {}
+
+MemoryArena::~MemoryArena()
+{
+    Release();
+}
+
+uint8_t *MemoryArena::Reserve(size_t bytes)
+{
+    if (memory && size >= bytes) {
+        return memory;
+    }
+    Release();
+
+#ifndef WIN32
+    // Prefer explicit huge pages, fall back to transparent huge pages if none are reserved
+    void *p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS
+#ifdef MAP_HUGETLB
+            | MAP_HUGETLB
+#endif
+            , -1, 0);
+    if (p == MAP_FAILED) {
+        p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) {
+            return nullptr;
+        }
+#ifdef MADV_HUGEPAGE
+        madvise(p, bytes, MADV_HUGEPAGE);
+#endif
+    }
+    memory = static_cast<uint8_t*>(p);
+#else
+    memory = static_cast<uint8_t*>(malloc(bytes));
+    if (!memory) {
+        return nullptr;
+    }
+#endif
+    size = bytes;
+    return memory;
+}
+
+void MemoryArena::Release()
+{
+    if (!memory) {
+        return;
+    }
+#ifndef WIN32
+    munmap(memory, size);
+#else
+    free(memory);
+#endif
+    memory = nullptr;
+    size = 0;
+}
+
 namespace 
 {
 void serializeMtpHeader(CDataStream & stream, CBlockHeader const & header)
@@ -670,7 +862,7 @@ void serializeMtpHeader(CDataStream & stream, CBlockHeader const & header)
 }
 }
 
-uint256 hash(CBlockHeader & blockHeader, uint256 const & powLimit)
+uint256 hash(CBlockHeader & blockHeader, uint256 const & powLimit, MemoryArena *arena, unsigned int nThreads)
 {
     if(!blockHeader.mtpHashData)
         blockHeader.mtpHashData = std::make_shared<CMTPHashData>();
@@ -680,7 +872,8 @@ uint256 hash(CBlockHeader & blockHeader, uint256 const & powLimit)
     
     uint256 result;
     impl::mtp_hash(reinterpret_cast<char*>(&ss[0]), blockHeader.nBits, blockHeader.mtpHashData->hashRootMTP
-            , blockHeader.nNonce, blockHeader.mtpHashData->nBlockMTP, blockHeader.mtpHashData->nProofMTP, powLimit, result);
+            , blockHeader.nNonce, blockHeader.mtpHashData->nBlockMTP, blockHeader.mtpHashData->nProofMTP, powLimit, result
+            , arena, nThreads);
     
     return result;
 }
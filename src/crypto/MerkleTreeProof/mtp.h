@@ -5,7 +5,7 @@ extern "C" {
 #include <inttypes.h>
 }
 #include "uint256.h"
-#include <deque>
+#include <cassert>
 #include <vector>
 
 class CBlockHeader;
@@ -16,6 +16,109 @@ namespace mtp
 /** L parameter for the MTP hash */
 constexpr int8_t MTP_L = 16;
 
+/** Memory for the Argon2 matrix kept between block templates
+ *
+ * The matrix is several GiB, allocating and faulting it in for every template
+ * is a large part of the cost of mining. The memory is backed by huge pages
+ * where the system provides them.
+ */
+class MemoryArena
+{
+public:
+    MemoryArena();
+    ~MemoryArena();
+
+    MemoryArena(const MemoryArena&) = delete;
+    MemoryArena& operator=(const MemoryArena&) = delete;
+
+    /** Return at least `bytes` of memory with unspecified contents, nullptr on failure */
+    uint8_t *Reserve(size_t bytes);
+
+    /** Give the memory back to the system */
+    void Release();
+
+private:
+    uint8_t *memory;
+    size_t size;
+};
+
+/** Merkle proofs for all the openings of an MTP solution
+ *
+ * The proof nodes of all MTP_L*3 proofs are stored back to back in a single
+ * buffer, proof `i` being the nodes between two consecutive offsets. Proofs
+ * are read in place through GetProof(), there is no per-node allocation.
+ */
+class ProofSet
+{
+public:
+    /** Size of a proof node: 128 bit of blake2b */
+    static const size_t NODE_SIZE = 16;
+    /** Number of proofs in a complete set */
+    static const size_t PROOF_COUNT = MTP_L*3;
+    /** Nodes in a proof of the full Argon2 matrix (2^22 leaves), used to size the buffer once */
+    static const size_t TYPICAL_PROOF_SIZE = 23;
+
+    ProofSet() { Clear(); }
+
+    void Clear()
+    {
+        nodes.clear();
+        nProofs = 0;
+        offsets[0] = 0;
+    }
+
+    /** Number of proofs appended so far */
+    size_t GetProofCount() const { return nProofs; }
+
+    /** Number of nodes in proof `i`, zero if it is missing */
+    size_t GetProofSize(size_t i) const
+    {
+        return i < nProofs ? offsets[i+1] - offsets[i] : 0;
+    }
+
+    /** Nodes of proof `i`, GetProofSize(i)*NODE_SIZE bytes */
+    const uint8_t *GetProof(size_t i) const
+    {
+        return nodes.data() + (size_t)offsets[i < nProofs ? i : nProofs] * NODE_SIZE;
+    }
+
+    uint8_t *GetProof(size_t i)
+    {
+        return nodes.data() + (size_t)offsets[i < nProofs ? i : nProofs] * NODE_SIZE;
+    }
+
+    /** Append the next proof of `count` nodes and return its storage to be filled in */
+    uint8_t *AppendProof(size_t count)
+    {
+        assert(nProofs < PROOF_COUNT);
+        if (nodes.capacity() == 0)
+            nodes.reserve(PROOF_COUNT * TYPICAL_PROOF_SIZE * NODE_SIZE);
+        size_t begin = nodes.size();
+        nodes.resize(begin + count * NODE_SIZE);
+        offsets[nProofs+1] = offsets[nProofs] + count;
+        ++nProofs;
+        return nodes.data() + begin;
+    }
+
+    /** Drop trailing nodes of proof `i` so it has `count` nodes, later proofs are kept */
+    void TruncateProof(size_t i, size_t count)
+    {
+        assert(i < nProofs && count <= GetProofSize(i));
+        size_t removed = GetProofSize(i) - count;
+        size_t end = (size_t)offsets[i+1] * NODE_SIZE;
+        nodes.erase(nodes.begin() + (end - removed * NODE_SIZE), nodes.begin() + end);
+        for (size_t j = i + 1; j <= nProofs; j++)
+            offsets[j] -= removed;
+    }
+
+    const std::vector<uint8_t> &GetNodes() const { return nodes; }
+
+private:
+    std::vector<uint8_t> nodes;
+    uint16_t offsets[PROOF_COUNT+1];
+    size_t nProofs;
+};
+
 /** Solve the hash problem
  *
  * This function will try different nonce until it finds one such that the
@@ -24,8 +127,10 @@ constexpr int8_t MTP_L = 16;
  * 
  * \param blockHeader   [in/out]    Transaction block which header will be used for calculation
  * \param pow_limit     [in]        Network limit (hash must be less than that)
+ * \param arena         [in]        Memory reused for the Argon2 matrix, allocated per call if null
+ * \param nThreads      [in]        Number of threads hashing the Merkle tree leaves and searching nonces
  */
-uint256 hash(CBlockHeader & blockHeader, uint256 const & powLimit);
+uint256 hash(CBlockHeader & blockHeader, uint256 const & powLimit, MemoryArena *arena = nullptr, unsigned int nThreads = 1);
 
 
 /** Verify the given nonce does satisfy the given difficulty
@@ -56,15 +161,20 @@ namespace impl
  * \param proof_mtp     [out] Merkle proofs for every element in `block_mtp`
  * \param pow_limit     [in]  Network limit (hash must be less than that)
  * \param output        [out] Resulting hash value for the given `nonce`
+ * \param arena         [in]  Memory reused for the Argon2 matrix, allocated per call if null
+ * \param nThreads      [in]  Number of threads sharing the Merkle tree; the smallest valid nonce
+ *                            is returned regardless of the number of threads
  */
 void mtp_hash(const char* input,
         uint32_t target,
         uint8_t hash_root_mtp[16],
         unsigned int& nonce,
         uint64_t block_mtp[MTP_L*2][128],
-        std::deque<std::vector<uint8_t>> proof_mtp[MTP_L*3],
+        ProofSet& proof_mtp,
         uint256 pow_limit,
-        uint256& output);
+        uint256& output,
+        MemoryArena *arena = nullptr,
+        unsigned int nThreads = 1);
 
 /** Verify the given nonce does satisfy the given difficulty
  *
@@ -86,7 +196,7 @@ bool mtp_verify(const char* input,
         const uint8_t hash_root_mtp[16],
         const uint32_t nonce,
         const uint64_t block_mtp[MTP_L*2][128],
-        const std::deque<std::vector<uint8_t>> proof_mtp[MTP_L*3],
+        const ProofSet& proof_mtp,
         uint256 pow_limit,
         uint256 *mtpHashValue=nullptr);
 }
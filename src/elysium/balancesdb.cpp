@@ -0,0 +1,303 @@
+#include "elysium/balancesdb.h"
+
+#include "elysium/elysium.h"
+#include "elysium/log.h"
+
+#include "clientversion.h"
+#include "streams.h"
+
+#include <leveldb/db.h>
+#include <leveldb/write_batch.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace elysium {
+
+namespace {
+
+// key prefixes
+const char DB_BALANCE = 'b';
+const char DB_UNDO = 'u';
+const char DB_WATERMARK = 'w';
+
+/** Previous balances of the entries changed by a block. */
+struct BalanceUndo
+{
+    uint256 blockHash;
+    int32_t prevBlock;
+    uint256 prevBlockHash;
+    std::vector<BalanceEntry> entries;
+
+    BalanceUndo() : prevBlock(-1) {}
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action)
+    {
+        READWRITE(blockHash);
+        READWRITE(prevBlock);
+        READWRITE(prevBlockHash);
+        READWRITE(entries);
+    }
+};
+
+// <1 byte of prefix><address><4 bytes of property id, big endian>
+std::string CreateBalanceKey(const std::string& address, uint32_t propertyId)
+{
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss.write(&DB_BALANCE, 1);
+    ss.write(address.data(), address.size());
+    ser_writedata32be(ss, propertyId);
+    return ss.str();
+}
+
+// <1 byte of prefix><4 bytes of block height, big endian>
+std::string CreateUndoKey(int block)
+{
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss.write(&DB_UNDO, 1);
+    ser_writedata32be(ss, static_cast<uint32_t>(block));
+    return ss.str();
+}
+
+std::string CreateWatermarkKey()
+{
+    return std::string(1, DB_WATERMARK);
+}
+
+template<typename T>
+std::string Serialize(const T& obj)
+{
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss << obj;
+    return ss.str();
+}
+
+template<typename T>
+bool Deserialize(const std::string& data, T& obj)
+{
+    try {
+        CDataStream ss(data.data(), data.data() + data.size(), SER_DISK, CLIENT_VERSION);
+        ss >> obj;
+    } catch (const std::exception& e) {
+        PrintToLog("%s(): failed to deserialize database entry: %s\n", __func__, e.what());
+        return false;
+    }
+    return true;
+}
+
+void PutWatermark(leveldb::WriteBatch& batch, int block, const uint256& blockHash)
+{
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss << static_cast<int32_t>(block) << blockHash;
+    batch.Put(CreateWatermarkKey(), ss.str());
+}
+
+} // namespace
+
+CElysiumBalancesDB::CElysiumBalancesDB(const boost::filesystem::path& path, bool fWipe)
+{
+    leveldb::Status status = Open(path, fWipe);
+    PrintToLog("Loading balances database: %s\n", status.ToString());
+}
+
+CElysiumBalancesDB::~CElysiumBalancesDB()
+{
+    if (elysium_debug_persistence) PrintToLog("CElysiumBalancesDB closed\n");
+}
+
+/**
+ * Stores the balances changed by a block.
+ *
+ * The previous balances of the changed entries are kept as undo record of the block,
+ * undo records older than MAX_STATE_HISTORY blocks are removed. All updates are
+ * written in a single batch, together with the new watermark.
+ */
+bool CElysiumBalancesDB::WriteBlock(int block, const uint256& blockHash, const std::vector<BalanceEntry>& changes)
+{
+    assert(pdb);
+
+    leveldb::WriteBatch batch;
+
+    BalanceUndo undo;
+    undo.blockHash = blockHash;
+    int prevBlock;
+    if (GetWatermark(prevBlock, undo.prevBlockHash)) {
+        undo.prevBlock = prevBlock;
+    }
+
+    undo.entries.reserve(changes.size());
+    for (const BalanceEntry& change : changes) {
+        const std::string key = CreateBalanceKey(change.address, change.propertyId);
+
+        BalanceEntry previous;
+        std::string value;
+        if (pdb->Get(readoptions, key, &value).ok()) {
+            if (!Deserialize(value, previous)) return false;
+            ++nRead;
+        } else {
+            previous.address = change.address;
+            previous.propertyId = change.propertyId;
+        }
+        undo.entries.push_back(previous);
+
+        if (change.IsEmpty()) {
+            batch.Delete(key);
+        } else {
+            batch.Put(key, Serialize(change));
+            ++nWritten;
+        }
+    }
+
+    batch.Put(CreateUndoKey(block), Serialize(undo));
+
+    // undo records are only needed as long as state files are kept
+    std::unique_ptr<leveldb::Iterator> it(NewIterator());
+    const std::string pruneKey = CreateUndoKey(std::max(0, block - MAX_STATE_HISTORY - 1));
+    for (it->Seek(CreateUndoKey(0)); it->Valid() && it->key().compare(pruneKey) < 0; it->Next()) {
+        batch.Delete(it->key());
+    }
+
+    PutWatermark(batch, block, blockHash);
+
+    leveldb::Status status = pdb->Write(writeoptions, &batch);
+    if (!status.ok()) {
+        PrintToLog("%s(): failed to store balances of block %d: %s\n", __func__, block, status.ToString());
+        return false;
+    }
+    if (elysium_debug_persistence) {
+        PrintToLog("%s(): stored %d changed balances of block %d\n", __func__, changes.size(), block);
+    }
+
+    return true;
+}
+
+/**
+ * Replaces the stored state with the given balances.
+ *
+ * Used when the state was restored from elsewhere, the state can't be rolled back
+ * past this block.
+ */
+bool CElysiumBalancesDB::WriteSnapshot(int block, const uint256& blockHash, const std::vector<BalanceEntry>& balances)
+{
+    assert(pdb);
+
+    Clear();
+
+    leveldb::WriteBatch batch;
+    for (const BalanceEntry& entry : balances) {
+        if (entry.IsEmpty()) continue;
+        batch.Put(CreateBalanceKey(entry.address, entry.propertyId), Serialize(entry));
+        ++nWritten;
+    }
+    PutWatermark(batch, block, blockHash);
+
+    leveldb::Status status = pdb->Write(syncoptions, &batch);
+    PrintToLog("%s(): stored %d balances as of block %d: %s\n", __func__, balances.size(), block, status.ToString());
+
+    return status.ok();
+}
+
+/**
+ * Rolls the stored state back to the given block.
+ *
+ * The undo records are applied one block after the other, starting with the most
+ * recent one. Each block is written in a single batch, so the database stays
+ * consistent, even if the rollback is interrupted.
+ *
+ * @return True, if the stored state is the state of the given block
+ */
+bool CElysiumBalancesDB::RollBack(int block, const uint256& blockHash)
+{
+    assert(pdb);
+
+    int currentBlock;
+    uint256 currentBlockHash;
+    if (!GetWatermark(currentBlock, currentBlockHash)) {
+        return false;
+    }
+
+    while (currentBlock > block) {
+        std::string value;
+        BalanceUndo undo;
+        if (!pdb->Get(readoptions, CreateUndoKey(currentBlock), &value).ok() || !Deserialize(value, undo)) {
+            PrintToLog("%s(): no undo record for block %d\n", __func__, currentBlock);
+            return false;
+        }
+        if (undo.blockHash != currentBlockHash || undo.prevBlock < 0) {
+            PrintToLog("%s(): undo record for block %d doesn't match the stored state\n", __func__, currentBlock);
+            return false;
+        }
+
+        leveldb::WriteBatch batch;
+        for (const BalanceEntry& entry : undo.entries) {
+            const std::string key = CreateBalanceKey(entry.address, entry.propertyId);
+            if (entry.IsEmpty()) {
+                batch.Delete(key);
+            } else {
+                batch.Put(key, Serialize(entry));
+            }
+        }
+        batch.Delete(CreateUndoKey(currentBlock));
+        PutWatermark(batch, undo.prevBlock, undo.prevBlockHash);
+
+        leveldb::Status status = pdb->Write(writeoptions, &batch);
+        if (!status.ok()) {
+            PrintToLog("%s(): failed to roll back block %d: %s\n", __func__, currentBlock, status.ToString());
+            return false;
+        }
+
+        currentBlock = undo.prevBlock;
+        currentBlockHash = undo.prevBlockHash;
+    }
+
+    return currentBlock == block && currentBlockHash == blockHash;
+}
+
+/**
+ * Obtains the block of the stored state.
+ */
+bool CElysiumBalancesDB::GetWatermark(int& block, uint256& blockHash) const
+{
+    assert(pdb);
+
+    std::string value;
+    if (!pdb->Get(readoptions, CreateWatermarkKey(), &value).ok()) {
+        return false;
+    }
+
+    int32_t height;
+    try {
+        CDataStream ss(value.data(), value.data() + value.size(), SER_DISK, CLIENT_VERSION);
+        ss >> height >> blockHash;
+    } catch (const std::exception& e) {
+        PrintToLog("%s(): failed to deserialize watermark: %s\n", __func__, e.what());
+        return false;
+    }
+    block = height;
+
+    return true;
+}
+
+/**
+ * Calls the given function for every stored balance.
+ */
+bool CElysiumBalancesDB::ForEachBalance(std::function<void(const BalanceEntry&)> func) const
+{
+    std::unique_ptr<leveldb::Iterator> it(NewIterator());
+
+    for (it->Seek(std::string(1, DB_BALANCE)); it->Valid() && it->key()[0] == DB_BALANCE; it->Next()) {
+        BalanceEntry entry;
+        if (!Deserialize(it->value().ToString(), entry)) {
+            return false;
+        }
+        func(entry);
+    }
+
+    return true;
+}
+
+} // namespace elysium
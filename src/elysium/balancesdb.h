@@ -0,0 +1,88 @@
+#ifndef ELYSIUM_BALANCESDB_H
+#define ELYSIUM_BALANCESDB_H
+
+#include "elysium/persistence.h"
+
+#include "serialize.h"
+#include "uint256.h"
+
+#include <boost/filesystem/path.hpp>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+namespace elysium {
+
+/** Balances of an address for one property, the pending amounts are not persisted.
+ */
+struct BalanceEntry
+{
+    std::string address;
+    uint32_t propertyId;
+    int64_t balance;
+    int64_t sellOfferReserve;
+    int64_t acceptReserve;
+    int64_t metaDExReserve;
+
+    BalanceEntry() : propertyId(0), balance(0), sellOfferReserve(0), acceptReserve(0), metaDExReserve(0) {}
+
+    bool IsEmpty() const
+    {
+        return !balance && !sellOfferReserve && !acceptReserve && !metaDExReserve;
+    }
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action)
+    {
+        READWRITE(address);
+        READWRITE(propertyId);
+        READWRITE(balance);
+        READWRITE(sellOfferReserve);
+        READWRITE(acceptReserve);
+        READWRITE(metaDExReserve);
+    }
+};
+
+/** LevelDB based storage of the balances of all addresses.
+ *
+ * The database is updated once per block with the balances changed by the block.
+ * For every block an undo record with the previous balances is kept, so that the
+ * state can be rolled back to one of the last MAX_STATE_HISTORY blocks without
+ * reparsing the chain. The block of the stored state is recorded as watermark.
+ */
+class CElysiumBalancesDB : public CDBBase
+{
+public:
+    CElysiumBalancesDB(const boost::filesystem::path& path, bool fWipe);
+    virtual ~CElysiumBalancesDB();
+
+    /** Stores the balances changed by a block, together with the undo record of the block. */
+    bool WriteBlock(int block, const uint256& blockHash, const std::vector<BalanceEntry>& changes);
+
+    /** Replaces the stored state with the given balances, no undo records are kept. */
+    bool WriteSnapshot(int block, const uint256& blockHash, const std::vector<BalanceEntry>& balances);
+
+    /** Rolls the stored state back to the given block, returns false if the undo records are missing.
+     *
+     * On failure the state may be left partially rolled back, at the oldest block reachable.
+     */
+    bool RollBack(int block, const uint256& blockHash);
+
+    /** Obtains the block of the stored state. */
+    bool GetWatermark(int& block, uint256& blockHash) const;
+
+    /** Calls the given function for every stored balance, returns false if an entry can't be read. */
+    bool ForEachBalance(std::function<void(const BalanceEntry&)> func) const;
+};
+
+//! LevelDB based storage of the balances
+extern CElysiumBalancesDB *p_balancesdb;
+
+} // namespace elysium
+
+#endif // ELYSIUM_BALANCESDB_H
@@ -17,7 +17,10 @@
 
 #include <stdint.h>
 #include <algorithm>
+#include <map>
+#include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <openssl/sha.h>
@@ -98,6 +101,87 @@ std::string GenerateConsensusString(const uint32_t propertyId, const std::string
     return strprintf("%d|%s", propertyId, address);
 }
 
+namespace {
+
+typedef std::pair<std::string, uint32_t> BalanceKey;
+
+//! Consensus strings of all non-empty balances, ordered by address and property, only valid if fBalanceStringsReady
+//! Once built, this keeps a formatted string for every non-empty balance in addition to the tally map for the life
+//! of the process, it is only released when the tally map is cleared.
+std::map<BalanceKey, std::string> mapBalanceStrings;
+//! Balances changed since their consensus strings were generated
+std::set<BalanceKey> setDirtyBalances;
+//! Whether mapBalanceStrings was built and changes are tracked
+bool fBalanceStringsReady = false;
+
+void RefreshBalanceString(const BalanceKey& key)
+{
+    std::string dataStr;
+    const CMPTally* tally = getTally(key.first);
+    if (tally) {
+        dataStr = GenerateConsensusString(*tally, key.first, key.second);
+    }
+
+    if (dataStr.empty()) {
+        mapBalanceStrings.erase(key);
+    } else {
+        mapBalanceStrings[key] = std::move(dataStr);
+    }
+}
+
+/**
+ * Brings the consensus strings of the balances up to date.
+ *
+ * The strings are built from the whole tally map on first use. After that only the
+ * balances that changed since the last call are regenerated.
+ */
+void UpdateBalanceStrings()
+{
+    AssertLockHeld(cs_main);
+
+    if (!fBalanceStringsReady) {
+        mapBalanceStrings.clear();
+        for (std::unordered_map<std::string, CMPTally>::iterator it = mp_tally_map.begin(); it != mp_tally_map.end(); ++it) {
+            CMPTally& tally = it->second;
+            tally.init();
+            uint32_t propertyId = 0;
+            while (0 != (propertyId = tally.next())) {
+                std::string dataStr = GenerateConsensusString(tally, it->first, propertyId);
+                if (dataStr.empty()) continue; // skip empty balances
+                mapBalanceStrings.emplace(BalanceKey(it->first, propertyId), std::move(dataStr));
+            }
+        }
+        setDirtyBalances.clear();
+        fBalanceStringsReady = true;
+        return;
+    }
+
+    for (std::set<BalanceKey>::const_iterator it = setDirtyBalances.begin(); it != setDirtyBalances.end(); ++it) {
+        RefreshBalanceString(*it);
+    }
+    setDirtyBalances.clear();
+}
+
+} // namespace
+
+void NotifyConsensusBalanceChanged(const std::string& address, uint32_t propertyId)
+{
+    AssertLockHeld(cs_main);
+
+    if (fBalanceStringsReady) {
+        setDirtyBalances.emplace(address, propertyId);
+    }
+}
+
+void ClearConsensusHashCache()
+{
+    AssertLockHeld(cs_main);
+
+    mapBalanceStrings.clear();
+    setDirtyBalances.clear();
+    fBalanceStringsReady = false;
+}
+
 /**
  * Obtains a hash of the active state to use for consensus verification and checkpointing.
  *
@@ -157,24 +241,14 @@ uint256 GetConsensusHash()
 
     if (elysium_debug_consensus_hash) PrintToLog("Beginning generation of current consensus hash...\n");
 
-    // Balances - loop through the tally map, updating the sha context with the data from each balance and tally type
+    // Balances - loop through the consensus strings of all balances, updating the sha context with each of them
     // Placeholders:  "address|propertyid|balance|selloffer_reserve|accept_reserve|metadex_reserve"
-    // Sort alphabetically first
-    std::map<std::string, CMPTally> tallyMapSorted;
-    for (std::unordered_map<string, CMPTally>::iterator uoit = mp_tally_map.begin(); uoit != mp_tally_map.end(); ++uoit) {
-        tallyMapSorted.insert(std::make_pair(uoit->first,uoit->second));
-    }
-    for (std::map<string, CMPTally>::iterator my_it = tallyMapSorted.begin(); my_it != tallyMapSorted.end(); ++my_it) {
-        const std::string& address = my_it->first;
-        CMPTally& tally = my_it->second;
-        tally.init();
-        uint32_t propertyId = 0;
-        while (0 != (propertyId = (tally.next()))) {
-            std::string dataStr = GenerateConsensusString(tally, address, propertyId);
-            if (dataStr.empty()) continue; // skip empty balances
-            if (elysium_debug_consensus_hash) PrintToLog("Adding balance data to consensus hash: %s\n", dataStr);
-            SHA256_Update(&shaCtx, dataStr.c_str(), dataStr.length());
-        }
+    // The strings are kept sorted by address and property, only the ones changed since the last hash are regenerated
+    UpdateBalanceStrings();
+    for (std::map<BalanceKey, std::string>::const_iterator it = mapBalanceStrings.begin(); it != mapBalanceStrings.end(); ++it) {
+        const std::string& dataStr = it->second;
+        if (elysium_debug_consensus_hash) PrintToLog("Adding balance data to consensus hash: %s\n", dataStr);
+        SHA256_Update(&shaCtx, dataStr.c_str(), dataStr.length());
     }
 
     // DEx sell offers - loop through the DEx and add each sell offer to the consensus hash (ordered by txid)
@@ -318,22 +392,15 @@ uint256 GetBalancesHash(const uint32_t hashPropertyId)
 
     LOCK(cs_main);
 
-    std::map<std::string, CMPTally> tallyMapSorted;
-    for (std::unordered_map<string, CMPTally>::iterator uoit = mp_tally_map.begin(); uoit != mp_tally_map.end(); ++uoit) {
-        tallyMapSorted.insert(std::make_pair(uoit->first,uoit->second));
-    }
-    for (std::map<string, CMPTally>::iterator my_it = tallyMapSorted.begin(); my_it != tallyMapSorted.end(); ++my_it) {
-        const std::string& address = my_it->first;
-        CMPTally& tally = my_it->second;
-        tally.init();
-        uint32_t propertyId = 0;
-        while (0 != (propertyId = (tally.next()))) {
-            if (propertyId != hashPropertyId) continue;
-            std::string dataStr = GenerateConsensusString(tally, address, propertyId);
-            if (dataStr.empty()) continue;
-            if (elysium_debug_consensus_hash) PrintToLog("Adding data to balances hash: %s\n", dataStr);
-            SHA256_Update(&shaCtx, dataStr.c_str(), dataStr.length());
-        }
+    // the holders of the property are ordered by address and are exactly the addresses with a non-empty balance
+    const std::set<std::string>& holders = getPropertyHolders(hashPropertyId);
+    for (std::set<std::string>::const_iterator it = holders.begin(); it != holders.end(); ++it) {
+        const CMPTally* tally = getTally(*it);
+        if (!tally) continue;
+        std::string dataStr = GenerateConsensusString(*tally, *it, hashPropertyId);
+        if (dataStr.empty()) continue;
+        if (elysium_debug_consensus_hash) PrintToLog("Adding data to balances hash: %s\n", dataStr);
+        SHA256_Update(&shaCtx, dataStr.c_str(), dataStr.length());
     }
 
     uint256 balancesHash;
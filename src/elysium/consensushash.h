@@ -3,6 +3,9 @@
 
 #include "uint256.h"
 
+#include <stdint.h>
+#include <string>
+
 namespace elysium
 {
 /** Checks if a given block should be consensus hashed. */
@@ -11,6 +14,12 @@ bool ShouldConsensusHashBlock(int block);
 /** Obtains a hash of all balances to use for consensus verification and checkpointing. */
 uint256 GetConsensusHash();
 
+/** Marks a balance as changed, so that its part of the consensus hash is regenerated. */
+void NotifyConsensusBalanceChanged(const std::string& address, uint32_t propertyId);
+
+/** Drops the cached balance data of the consensus hash, must be called whenever the tally map is cleared. */
+void ClearConsensusHashCache();
+
 /** Obtains a hash of the overall MetaDEx state (default) or a specific orderbook (supply a property ID). */
 uint256 GetMetaDExHash(const uint32_t propertyId = 0);
 
@@ -1,6 +1,7 @@
 #include "elysium.h"
 
 #include "activation.h"
+#include "balancesdb.h"
 #include "consensushash.h"
 #include "convert.h"
 #include "dex.h"
@@ -17,6 +18,7 @@
 #include "sigmadb.h"
 #include "sp.h"
 #include "tally.h"
+#include "tallyindex.h"
 #include "tx.h"
 #include "txprocessor.h"
 #include "utils.h"
@@ -30,11 +32,13 @@
 
 #include "../base58.h"
 #include "../chainparams.h"
+#include "../ctpl.h"
 #include "../wallet/coincontrol.h"
 #include "../coins.h"
 #include "../core_io.h"
 #include "../init.h"
 #include "../validation.h"
+#include "../memusage.h"
 #include "../net.h"
 #include "../primitives/block.h"
 #include "../primitives/transaction.h"
@@ -69,8 +73,11 @@
 #include <stdint.h>
 #include <stdio.h>
 
+#include <deque>
 #include <fstream>
+#include <future>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -130,6 +137,7 @@ CMPSTOList *elysium::s_stolistdb;
 CElysiumTransactionDB *elysium::p_ElysiumTXDB;
 CElysiumFeeCache *elysium::p_feecache;
 CElysiumFeeHistory *elysium::p_feehistory;
+CElysiumBalancesDB *elysium::p_balancesdb;
 
 // indicate whether persistence is enabled at this point, or not
 // used to write/read files, for breakout mode, debugging, etc.
@@ -245,6 +253,12 @@ CrowdMap elysium::my_crowds;
 // this is the master list of all amounts for all addresses for all properties, map is unsorted
 std::unordered_map<std::string, CMPTally> elysium::mp_tally_map;
 
+// running totals and holders of each property, kept in sync with mp_tally_map by update_tally_map()
+CMPTallyIndex elysium::mp_tally_index;
+
+// balances changed since they were last stored in the balances database
+static std::set<std::pair<std::string, uint32_t>> setBalancesChanged;
+
 CMPTally* elysium::getTally(const std::string& address)
 {
     std::unordered_map<std::string, CMPTally>::iterator it = mp_tally_map.find(address);
@@ -254,6 +268,36 @@ CMPTally* elysium::getTally(const std::string& address)
     return (CMPTally *) NULL;
 }
 
+/**
+ * Logs the number of tallies and balance records, and the memory used by
+ * them.
+ */
+static void LogTallyMemoryUsage()
+{
+    LOCK(cs_main);
+
+    size_t nRecords = 0;
+    size_t nUsage = memusage::DynamicUsage(mp_tally_map);
+    for (const auto& entry : mp_tally_map) {
+        // addresses are longer than the inline buffer of std::string
+        if (entry.first.capacity() >= sizeof(std::string)) {
+            nUsage += memusage::MallocUsage(entry.first.capacity() + 1);
+        }
+        nRecords += entry.second.size();
+        nUsage += entry.second.DynamicMemoryUsage();
+    }
+
+    PrintToLog("Tally map: %zu addresses, %zu balance records, %.1f MiB\n",
+        mp_tally_map.size(), nRecords, nUsage / (1024.0 * 1024.0));
+}
+
+const std::set<std::string>& elysium::getPropertyHolders(uint32_t propertyId)
+{
+    AssertLockHeld(cs_main);
+
+    return mp_tally_index.GetHolders(propertyId);
+}
+
 // look at balance for an address
 int64_t getMPbalance(const std::string& address, uint32_t propertyId, TallyType ttype)
 {
@@ -418,8 +462,6 @@ std::string elysium::getTokenLabel(uint32_t propertyId)
 // optionally counts the number of addresses who own that property: n_owners_total
 int64_t elysium::getTotalTokens(uint32_t propertyId, int64_t* n_owners_total)
 {
-    int64_t prev = 0;
-    int64_t owners = 0;
     int64_t totalTokens = 0;
 
     LOCK(cs_main);
@@ -429,29 +471,14 @@ int64_t elysium::getTotalTokens(uint32_t propertyId, int64_t* n_owners_total)
         return 0; // property ID does not exist
     }
 
-    if (!property.fixed || n_owners_total) {
-        for (std::unordered_map<std::string, CMPTally>::const_iterator it = mp_tally_map.begin(); it != mp_tally_map.end(); ++it) {
-            const CMPTally& tally = it->second;
-
-            totalTokens += tally.getMoney(propertyId, BALANCE);
-            totalTokens += tally.getMoney(propertyId, SELLOFFER_RESERVE);
-            totalTokens += tally.getMoney(propertyId, ACCEPT_RESERVE);
-            totalTokens += tally.getMoney(propertyId, METADEX_RESERVE);
-
-            if (prev != totalTokens) {
-                prev = totalTokens;
-                owners++;
-            }
-        }
-        int64_t cachedFee = p_feecache->GetCachedAmount(propertyId);
-        totalTokens += cachedFee;
-    }
-
     if (property.fixed) {
         totalTokens = property.num_tokens; // only valid for TX50
+    } else {
+        totalTokens = mp_tally_index.GetTotal(propertyId);
+        totalTokens += p_feecache->GetCachedAmount(propertyId);
     }
 
-    if (n_owners_total) *n_owners_total = owners;
+    if (n_owners_total) *n_owners_total = mp_tally_index.GetHolderCount(propertyId);
 
     return totalTokens;
 }
@@ -487,7 +514,14 @@ bool elysium::update_tally_map(const std::string& who, uint32_t propertyId, int6
     }
 
     CMPTally& tally = my_it->second;
+    int64_t heldBefore = tally.getMoney(propertyId, BALANCE) + tally.getMoneyReserved(propertyId);
     bRet = tally.updateMoney(propertyId, amount, ttype);
+    if (bRet && ttype != PENDING) {
+        int64_t heldAfter = tally.getMoney(propertyId, BALANCE) + tally.getMoneyReserved(propertyId);
+        mp_tally_index.Update(who, propertyId, heldBefore, heldAfter);
+        NotifyConsensusBalanceChanged(who, propertyId);
+        setBalancesChanged.emplace(who, propertyId);
+    }
 
     after = getMPbalance(who, propertyId, ttype);
     if (!bRet) {
@@ -1101,6 +1135,16 @@ public:
     {
     }
 
+    /** Returns the number of blocks scanned per second so far. */
+    double blocksPerSecond(const CBlockIndex* pblockNow) const
+    {
+        int64_t timeSinceStart = GetTimeMillis() - m_timeStart;
+        if (timeSinceStart <= 0) {
+            return 0.0;
+        }
+        return 1000.0 * (pblockNow->nHeight - m_pblockFirst->nHeight + 1) / timeSinceStart;
+    }
+
     /** Prints the current progress to the console and notifies the UI. */
     void update(const CBlockIndex* pblockNow) const
     {
@@ -1112,10 +1156,11 @@ public:
 
         double dProgress = 100.0 * (nCurrent - nFirst) / (nLast - nFirst);
         int64_t nRemainingTime = estimateRemainingTime(dProgress);
+        double dBlocksPerSecond = blocksPerSecond(pblockNow);
 
         std::string strProgress = strprintf(
-                "Still scanning.. at block %d of %d. Progress: %.2f %%, about %s remaining..\n",
-                nCurrentBlock, nLastBlock, dProgress, remainingTimeAsString(nRemainingTime));
+                "Still scanning.. at block %d of %d. Progress: %.2f %%, %.1f blocks/s, about %s remaining..\n",
+                nCurrentBlock, nLastBlock, dProgress, dBlocksPerSecond, remainingTimeAsString(nRemainingTime));
         std::string strProgressUI = strprintf(
                 "Still scanning.. at block %d of %d.\nProgress: %.2f %% (about %s remaining)",
                 nCurrentBlock, nLastBlock, dProgress, remainingTimeAsString(nRemainingTime));
@@ -1125,12 +1170,53 @@ public:
     }
 };
 
+//! Default number of blocks read ahead of the initial scan
+static const int DEFAULT_ELYSIUM_SCAN_READAHEAD = 32;
+
+/**
+ * A block read from the disk ahead of the scan.
+ *
+ * Next to the block it holds the result of the pre-filter, which marks the
+ * transactions carrying an Elysium marker. The pre-filter only looks at the
+ * outputs of a transaction and doesn't touch any state, so it runs on the
+ * readahead threads.
+ */
+struct PrefetchedBlock
+{
+    bool fRead = false;
+    CBlock block;
+    std::vector<bool> vCandidates;
+};
+
+static std::shared_ptr<PrefetchedBlock> PrefetchBlock(const CBlockIndex* pblockindex)
+{
+    auto prefetched = std::make_shared<PrefetchedBlock>();
+
+    if (!ReadBlockFromDisk(prefetched->block, pblockindex, Params().GetConsensus())) {
+        return prefetched;
+    }
+    prefetched->fRead = true;
+
+    prefetched->vCandidates.reserve(prefetched->block.vtx.size());
+    for (const auto& tx : prefetched->block.vtx) {
+        prefetched->vCandidates.push_back(bool(DeterminePacketClass(*tx, pblockindex->nHeight)));
+    }
+
+    return prefetched;
+}
+
 /**
  * Scans the blockchain for meta transactions.
  *
  * It scans the blockchain, starting at the given block index, to the current
  * tip, much like as if new block were arriving and being processed on the fly.
  *
+ * Blocks are read from the disk and pre-filtered by a pool of readahead
+ * threads, up to -elysiumscanreadahead blocks in front of the block being
+ * processed. The state is only updated by this thread, one block after the
+ * other and in the order of the chain. Transactions without an Elysium marker
+ * can't affect the state, so only their pending amounts are cleared.
+ *
  * Every 30 seconds the progress of the scan is reported.
  *
  * In case the current block being processed is not part of the active chain, or
@@ -1148,6 +1234,7 @@ static int elysium_initial_scan(int nFirstBlock)
 {
     int nTimeBetweenProgressReports = GetArg("-elysiumprogressfrequency", 30);  // seconds
     int64_t nNow = GetTime();
+    int64_t nTimeStart = GetTimeMillis();
     size_t nTxsTotal = 0, nTxsFoundTotal = 0;
     int nBlock = 999999;
     const int nLastBlock = GetHeight();
@@ -1159,6 +1246,17 @@ static int elysium_initial_scan(int nFirstBlock)
     // used to print the progress to the console and notifies the UI
     ProgressReporter progressReporter(chainActive[nFirstBlock], chainActive[nLastBlock]);
 
+    int nThreads = GetArg("-elysiumscanthreads", std::max(1, std::min(GetNumCores() - 1, 4)));
+    nThreads = std::max(1, nThreads);
+    size_t nReadahead = std::max(1, (int)GetArg("-elysiumscanreadahead", DEFAULT_ELYSIUM_SCAN_READAHEAD));
+
+    ctpl::thread_pool readaheadPool(nThreads);
+    RenameThreadPool(readaheadPool, "elysium-scan");
+
+    // blocks being read, in the order of the chain, the front is the next block to process
+    std::deque<std::future<std::shared_ptr<PrefetchedBlock>>> readahead;
+    int nNextPrefetch = nFirstBlock;
+
     for (nBlock = nFirstBlock; nBlock <= nLastBlock; ++nBlock)
     {
         if (ShutdownRequested()) {
@@ -1178,12 +1276,24 @@ static int elysium_initial_scan(int nFirstBlock)
             nNow = GetTime();
         }
 
+        // Keep the readahead window filled.
+        while (readahead.size() < nReadahead && nNextPrefetch <= nLastBlock) {
+            const CBlockIndex* pblockPrefetch = chainActive[nNextPrefetch++];
+            if (NULL == pblockPrefetch) break;
+            readahead.push_back(readaheadPool.push([pblockPrefetch](int) {
+                return PrefetchBlock(pblockPrefetch);
+            }));
+        }
+        if (readahead.empty()) break;
+
         // Get block to parse.
-        CBlock block;
+        std::shared_ptr<PrefetchedBlock> prefetched = readahead.front().get();
+        readahead.pop_front();
 
-        if (!ReadBlockFromDisk(block, pblockindex, Params().GetConsensus())) {
+        if (!prefetched->fRead) {
             break;
         }
+        const CBlock& block = prefetched->block;
 
         // Parse block.
         unsigned parsed = 0;
@@ -1191,6 +1301,11 @@ static int elysium_initial_scan(int nFirstBlock)
         elysium_handler_block_begin(nBlock, pblockindex);
 
         for (unsigned i = 0; i < block.vtx.size(); i++) {
+            if (!prefetched->vCandidates[i]) {
+                LOCK(cs_main);
+                PendingDelete(block.vtx[i]->GetHash());
+                continue;
+            }
             if (elysium_handler_tx(*block.vtx[i], nBlock, i, pblockindex)) {
                 parsed++;
             }
@@ -1203,11 +1318,18 @@ static int elysium_initial_scan(int nFirstBlock)
         nTxsTotal += block.vtx.size();
     }
 
+    // Blocks still queued are not needed anymore.
+    readaheadPool.clear_queue();
+    readaheadPool.stop(true);
+
     if (nBlock < nLastBlock) {
         PrintToLog("Scan stopped early at block %d of block %d\n", nBlock, nLastBlock);
     }
 
-    PrintToLog("%zu transactions processed, %zu meta transactions found\n", nTxsTotal, nTxsFoundTotal);
+    int64_t nTimeElapsed = std::max<int64_t>(1, GetTimeMillis() - nTimeStart);
+    PrintToLog("%zu transactions processed, %zu meta transactions found, %.1f blocks/s\n",
+        nTxsTotal, nTxsFoundTotal, 1000.0 * (nBlock - nFirstBlock) / nTimeElapsed);
+    LogTallyMemoryUsage();
 
     return 0;
 }
@@ -1432,6 +1554,8 @@ static int elysium_file_load(const string &filename, int what, bool verifyHash =
   {
     case FILETYPE_BALANCES:
       mp_tally_map.clear();
+      mp_tally_index.Clear();
+      ClearConsensusHashCache();
       inputLineFunc = input_elysium_balances_string;
       break;
 
@@ -1544,6 +1668,73 @@ static char const * const statePrefix[NUM_FILETYPES] = {
     "mdexorders",
 };
 
+static BalanceEntry GetBalanceEntry(const std::string& address, uint32_t propertyId, const CMPTally& tally)
+{
+    BalanceEntry entry;
+    entry.address = address;
+    entry.propertyId = propertyId;
+    entry.balance = tally.getMoney(propertyId, BALANCE);
+    entry.sellOfferReserve = tally.getMoney(propertyId, SELLOFFER_RESERVE);
+    entry.acceptReserve = tally.getMoney(propertyId, ACCEPT_RESERVE);
+    entry.metaDExReserve = tally.getMoney(propertyId, METADEX_RESERVE);
+    return entry;
+}
+
+/**
+ * Loads the balances as of the given block.
+ *
+ * The balances database is rolled back to the block using its undo records. Balances
+ * persisted in state files by earlier versions are still loaded, and then stored in
+ * the database.
+ *
+ * @return 0 on success, a negative value if the balances of the block are not available
+ */
+static int load_balances(CBlockIndex const *pBlockIndex)
+{
+  const uint256 blockHash = pBlockIndex->GetBlockHash();
+
+  if (p_balancesdb->RollBack(pBlockIndex->nHeight, blockHash)) {
+    mp_tally_map.clear();
+    mp_tally_index.Clear();
+    ClearConsensusHashCache();
+
+    bool fLoaded = p_balancesdb->ForEachBalance([](const BalanceEntry& entry) {
+        if (entry.balance) update_tally_map(entry.address, entry.propertyId, entry.balance, BALANCE);
+        if (entry.sellOfferReserve) update_tally_map(entry.address, entry.propertyId, entry.sellOfferReserve, SELLOFFER_RESERVE);
+        if (entry.acceptReserve) update_tally_map(entry.address, entry.propertyId, entry.acceptReserve, ACCEPT_RESERVE);
+        if (entry.metaDExReserve) update_tally_map(entry.address, entry.propertyId, entry.metaDExReserve, METADEX_RESERVE);
+    });
+    setBalancesChanged.clear();
+
+    PrintToLog("%s(): loaded %d addresses from the balances database, res= %d\n", __func__, mp_tally_map.size(), fLoaded ? 0 : -1);
+    LogTallyMemoryUsage();
+    return fLoaded ? 0 : -1;
+  }
+
+  boost::filesystem::path path = MPPersistencePath / strprintf("%s-%s.dat", statePrefix[FILETYPE_BALANCES], blockHash.ToString());
+  if (elysium_file_load(path.string(), FILETYPE_BALANCES, true) < 0) {
+    return -1;
+  }
+  setBalancesChanged.clear();
+
+  // move the balances of the state file into the database
+  std::vector<BalanceEntry> balances;
+  for (std::unordered_map<std::string, CMPTally>::iterator it = mp_tally_map.begin(); it != mp_tally_map.end(); ++it) {
+    CMPTally& tally = it->second;
+    tally.init();
+    uint32_t propertyId = 0;
+    while (0 != (propertyId = tally.next())) {
+      balances.push_back(GetBalanceEntry(it->first, propertyId, tally));
+    }
+  }
+  if (!p_balancesdb->WriteSnapshot(pBlockIndex->nHeight, blockHash, balances)) {
+    return -1;
+  }
+  boost::filesystem::remove(path);
+
+  return 0;
+}
+
 // returns the height of the state loaded
 static int load_most_relevant_state()
 {
@@ -1615,6 +1806,7 @@ static int load_most_relevant_state()
     if (persistedBlocks.find(spBlockIndex->GetBlockHash()) != persistedBlocks.end()) {
       int success = -1;
       for (int i = 0; i < NUM_FILETYPES; ++i) {
+        if (i == FILETYPE_BALANCES) continue; // stored in the balances database
         boost::filesystem::path path = MPPersistencePath / strprintf("%s-%s.dat", statePrefix[i], curTip->GetBlockHash().ToString());
         const std::string strFile = path.string();
         success = elysium_file_load(strFile, i, true);
@@ -1622,6 +1814,9 @@ static int load_most_relevant_state()
           break;
         }
       }
+      if (success >= 0) {
+        success = load_balances(curTip);
+      }
 
       if (success >= 0) {
         res = curTip->nHeight;
@@ -1652,6 +1847,34 @@ static int load_most_relevant_state()
   return res;
 }
 
+/**
+ * Stores the balances changed since the last call in the balances database.
+ */
+static bool write_changed_balances(CBlockIndex const *pBlockIndex)
+{
+    std::vector<BalanceEntry> changes;
+    changes.reserve(setBalancesChanged.size());
+
+    for (std::set<std::pair<std::string, uint32_t>>::const_iterator it = setBalancesChanged.begin(); it != setBalancesChanged.end(); ++it) {
+        const CMPTally* tally = getTally(it->first);
+        if (tally) {
+            changes.push_back(GetBalanceEntry(it->first, it->second, *tally));
+        } else {
+            BalanceEntry entry;
+            entry.address = it->first;
+            entry.propertyId = it->second;
+            changes.push_back(entry);
+        }
+    }
+
+    if (!p_balancesdb->WriteBlock(pBlockIndex->nHeight, pBlockIndex->GetBlockHash(), changes)) {
+        return false;
+    }
+    setBalancesChanged.clear();
+
+    return true;
+}
+
 static int write_elysium_balances(std::ofstream& file, SHA256_CTX* shaCtx)
 {
     std::unordered_map<std::string, CMPTally>::iterator iter;
@@ -1893,8 +2116,7 @@ static void prune_state_files( CBlockIndex const *topIndex )
 
 int elysium_save_state( CBlockIndex const *pBlockIndex )
 {
-    // write the new state as of the given block
-    write_state_file(pBlockIndex, FILETYPE_BALANCES);
+    // write the new state as of the given block, the balances are stored in the balances database
     write_state_file(pBlockIndex, FILETYPE_OFFERS);
     write_state_file(pBlockIndex, FILETYPE_ACCEPTS);
     write_state_file(pBlockIndex, FILETYPE_GLOBALS);
@@ -1918,6 +2140,8 @@ void clear_all_state()
 
     // Memory based storage
     mp_tally_map.clear();
+    mp_tally_index.Clear();
+    ClearConsensusHashCache();
     my_offers.clear();
     my_accepts.clear();
     my_crowds.clear();
@@ -1937,6 +2161,8 @@ void clear_all_state()
     p_ElysiumTXDB->Clear();
     p_feecache->Clear();
     p_feehistory->Clear();
+    p_balancesdb->Clear();
+    setBalancesChanged.clear();
     assert(p_txlistdb->setDBVersion() == DB_VERSION); // new set of databases, set DB version
     elysium_prev = 0;
 
@@ -1988,6 +2214,7 @@ int elysium_init()
             boost::filesystem::path elysiumTXDBPath = GetDataDir() / "Elysium_TXDB";
             boost::filesystem::path feesPath = GetDataDir() / "ELYSIUM_feecache";
             boost::filesystem::path feeHistoryPath = GetDataDir() / "ELYSIUM_feehistory";
+            boost::filesystem::path balancesPath = GetDataDir() / "ELYSIUM_balances";
             if (boost::filesystem::exists(persistPath)) boost::filesystem::remove_all(persistPath);
             if (boost::filesystem::exists(txlistPath)) boost::filesystem::remove_all(txlistPath);
             if (boost::filesystem::exists(tradePath)) boost::filesystem::remove_all(tradePath);
@@ -1996,6 +2223,7 @@ int elysium_init()
             if (boost::filesystem::exists(elysiumTXDBPath)) boost::filesystem::remove_all(elysiumTXDBPath);
             if (boost::filesystem::exists(feesPath)) boost::filesystem::remove_all(feesPath);
             if (boost::filesystem::exists(feeHistoryPath)) boost::filesystem::remove_all(feeHistoryPath);
+            if (boost::filesystem::exists(balancesPath)) boost::filesystem::remove_all(balancesPath);
             PrintToLog("Success clearing persistence files in datadir %s\n", GetDataDir().string());
             startClean = true;
         } catch (const boost::filesystem::filesystem_error& e) {
@@ -2011,6 +2239,7 @@ int elysium_init()
     p_ElysiumTXDB = new CElysiumTransactionDB(GetDataDir() / "Elysium_TXDB", fReindex);
     p_feecache = new CElysiumFeeCache(GetDataDir() / "ELYSIUM_feecache", fReindex);
     p_feehistory = new CElysiumFeeHistory(GetDataDir() / "ELYSIUM_feehistory", fReindex);
+    p_balancesdb = new CElysiumBalancesDB(GetDataDir() / "ELYSIUM_balances", fReindex);
 
     MPPersistencePath = GetDataDir() / "MP_persist";
     TryCreateDirectory(MPPersistencePath);
@@ -2126,6 +2355,7 @@ int elysium_shutdown()
     delete p_ElysiumTXDB; p_ElysiumTXDB = nullptr;
     delete p_feecache; p_feecache = nullptr;
     delete p_feehistory; p_feehistory = nullptr;
+    delete p_balancesdb; p_balancesdb = nullptr;
 
     elysiumInitialized = 0;
 
@@ -3799,6 +4029,15 @@ int elysium_handler_block_end(int nBlockNow, CBlockIndex const * pBlockIndex,
         PrintToLog("Consensus hash for block %d: %s\n", nBlockNow, consensusHash.GetHex());
     }
 
+    // store the balances changed by this block
+    if (!write_changed_balances(pBlockIndex)) {
+        std::string strShutdownReason = strprintf("Failed to store the balances of block %d.  It is unsafe to continue.\n", nBlockNow);
+        PrintToLog(strShutdownReason);
+        if (!GetBoolArg("-overrideforcedshutdown", false)) {
+            AbortNode(strShutdownReason, strShutdownReason);
+        }
+    }
+
     // request checkpoint verification
     bool checkpointValid = VerifyCheckpoint(nBlockNow, pBlockIndex->GetBlockHash());
     if (!checkpointValid) {
@@ -9,6 +9,7 @@ class CTransaction;
 #include "log.h"
 #include "persistence.h"
 #include "tally.h"
+#include "tallyindex.h"
 #include "sigma.h"
 #include "sigmadb.h"
 
@@ -269,6 +270,7 @@ int elysium_save_state( CBlockIndex const *pBlockIndex );
 namespace elysium
 {
 extern std::unordered_map<std::string, CMPTally> mp_tally_map;
+extern CMPTallyIndex mp_tally_index;
 extern CMPTxList *p_txlistdb;
 extern CMPTradeList *t_tradelistdb;
 extern CMPSTOList *s_stolistdb;
@@ -301,6 +303,9 @@ uint32_t GetNextPropertyId(bool maineco); // maybe move into sp
 
 CMPTally* getTally(const std::string& address);
 
+/** Returns the addresses holding tokens of a property, must be called with cs_main held. */
+const std::set<std::string>& getPropertyHolders(uint32_t propertyId);
+
 int64_t getTotalTokens(uint32_t propertyId, int64_t* n_owners_total = NULL);
 
 std::string strTransactionType(uint16_t txType);
@@ -865,20 +865,8 @@ UniValue elysium_getallbalancesforid(const JSONRPCRequest& request)
 
     LOCK(cs_main);
 
-    for (std::unordered_map<std::string, CMPTally>::iterator it = mp_tally_map.begin(); it != mp_tally_map.end(); ++it) {
-        uint32_t id = 0;
-        bool includeAddress = false;
-        std::string address = it->first;
-        (it->second).init();
-        while (0 != (id = (it->second).next())) {
-            if (id == propertyId) {
-                includeAddress = true;
-                break;
-            }
-        }
-        if (!includeAddress) {
-            continue; // ignore this address, has never transacted in this propertyId
-        }
+    // only addresses currently holding tokens of the property are considered
+    for (const std::string& address : getPropertyHolders(propertyId)) {
         UniValue balanceObj(UniValue::VOBJ);
         balanceObj.push_back(Pair("address", address));
         bool nonEmptyBalance = BalanceToJSON(address, propertyId, balanceObj, isDivisible);
@@ -40,6 +40,12 @@ SigmaParams::SigmaParams(const secp_primitives::GroupElement& g, unsigned m, uns
         h[i].generate(hash.data());
         h[i].sha256(hash.data());
     }
+
+    std::vector<secp_primitives::GroupElement> gens;
+    gens.reserve(h.size() + 1);
+    gens.push_back(g);
+    gens.insert(gens.end(), h.begin(), h.end());
+    gensTable = std::make_shared<secp_primitives::PrecomputedMultiExponent>(gens);
 }
 
 // SigmaPrivateKey Implementation.
@@ -11,12 +11,14 @@
 #include "../sigma/sigmaplus_verifier.h"
 
 #include <GroupElement.h>
+#include <PrecomputedMultiExponent.h>
 #include <Scalar.h>
 
 #include <boost/optional.hpp>
 
 #include <functional>
 #include <iterator>
+#include <memory>
 #include <ostream>
 #include <stdexcept>
 #include <vector>
@@ -36,6 +38,9 @@ public:
     unsigned m, n;
     std::vector<secp_primitives::GroupElement> h;
 
+    // Fixed-base tables of g followed by h, used to verify proofs.
+    std::shared_ptr<const secp_primitives::PrecomputedMultiExponent> gensTable;
+
 public:
     SigmaParams(const secp_primitives::GroupElement& g, unsigned m, unsigned n);
 };
@@ -143,7 +148,8 @@ public:
             params.g,
             params.h,
             params.n,
-            params.m
+            params.m,
+            params.gensTable.get()
         );
 
         return verifier.verify(commits, proof, fPadding);
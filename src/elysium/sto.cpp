@@ -41,17 +41,13 @@ OwnerAddrType STO_GetReceivers(const std::string& sender, uint32_t property, int
 
     {
         LOCK(cs_main);
-        std::unordered_map<std::string, CMPTally>::iterator it;
 
-        for (it = mp_tally_map.begin(); it != mp_tally_map.end(); ++it) {
-            const std::string& address = it->first;
-            const CMPTally& tally = it->second;
+        // only holders with balance are relevant
+        for (const std::string& address : getPropertyHolders(property)) {
+            const CMPTally* tally = getTally(address);
+            assert(tally);
 
-            int64_t tokens = 0;
-            tokens += tally.getMoney(property, BALANCE);
-            tokens += tally.getMoney(property, SELLOFFER_RESERVE);
-            tokens += tally.getMoney(property, ACCEPT_RESERVE);
-            tokens += tally.getMoney(property, METADEX_RESERVE);
+            int64_t tokens = tally->getMoney(property, BALANCE) + tally->getMoneyReserved(property);
 
             // Do not include the sender
             if (address == sender) {
@@ -61,7 +57,6 @@ OwnerAddrType STO_GetReceivers(const std::string& sender, uint32_t property, int
 
             totalTokens += tokens;
 
-            // Only holders with balance are relevant
             if (0 < tokens) {
                 ownerAddrSet.insert(std::make_pair(tokens, address));
             }
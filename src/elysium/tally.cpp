@@ -3,15 +3,67 @@
 #include "elysium/log.h"
 #include "elysium/elysium.h"
 
+#include "memusage.h"
+
+#include <algorithm>
+#include <limits>
 #include <stdint.h>
-#include <map>
+#include <vector>
 
 /**
  * Creates an empty tally.
  */
-CMPTally::CMPTally()
+CMPTally::CMPTally() : my_pos(0)
+{
+}
+
+/**
+ * Orders balance records by property identifier.
+ */
+template<typename Record>
+static bool RecordBeforeProperty(const Record& record, uint32_t propertyId)
+{
+    return record.first < propertyId;
+}
+
+/**
+ * Returns the balance record of the token.
+ *
+ * @param propertyId  The identifier of the token
+ * @return An iterator to the balance record, or end(), if there is none
+ */
+CMPTally::TokenMap::const_iterator CMPTally::find(uint32_t propertyId) const
+{
+    TokenMap::const_iterator it = std::lower_bound(mp_token.begin(), mp_token.end(), propertyId,
+            RecordBeforeProperty<TokenMap::value_type>);
+
+    if (it != mp_token.end() && it->first == propertyId) {
+        return it;
+    }
+
+    return mp_token.end();
+}
+
+/**
+ * Returns the balance record of the token and inserts an empty one, if there
+ * is none.
+ *
+ * Inserting a record moves the records of higher property identifiers, so
+ * references to records are only valid until the next insertion.
+ *
+ * @param propertyId  The identifier of the token
+ * @return The balance record
+ */
+CMPTally::BalanceRecord& CMPTally::lookupOrInsert(uint32_t propertyId)
 {
-    my_it = mp_token.begin();
+    TokenMap::iterator it = std::lower_bound(mp_token.begin(), mp_token.end(), propertyId,
+            RecordBeforeProperty<TokenMap::value_type>);
+
+    if (it == mp_token.end() || it->first != propertyId) {
+        it = mp_token.insert(it, std::make_pair(propertyId, BalanceRecord()));
+    }
+
+    return it->second;
 }
 
 /**
@@ -22,9 +74,9 @@ CMPTally::CMPTally()
 uint32_t CMPTally::init()
 {
     uint32_t propertyId = 0;
-    my_it = mp_token.begin();
-    if (my_it != mp_token.end()) {
-        propertyId = my_it->first;
+    my_pos = 0;
+    if (my_pos < mp_token.size()) {
+        propertyId = mp_token[my_pos].first;
     }
     return propertyId;
 }
@@ -37,9 +89,9 @@ uint32_t CMPTally::init()
 uint32_t CMPTally::next()
 {
     uint32_t ret = 0;
-    if (my_it != mp_token.end()) {
-        ret = my_it->first;
-        ++my_it;
+    if (my_pos < mp_token.size()) {
+        ret = mp_token[my_pos].first;
+        ++my_pos;
     }
     return ret;
 }
@@ -73,7 +125,8 @@ bool CMPTally::updateMoney(uint32_t propertyId, int64_t amount, TallyType ttype)
         return false;
     }
     bool fUpdated = false;
-    int64_t now64 = mp_token[propertyId].balance[ttype];
+    BalanceRecord& record = lookupOrInsert(propertyId);
+    int64_t now64 = record.balance[ttype];
 
     if (isOverflow(now64, amount)) {
         PrintToLog("%s(): ERROR: arithmetic overflow [%d + %d]\n", __func__, now64, amount);
@@ -86,7 +139,7 @@ bool CMPTally::updateMoney(uint32_t propertyId, int64_t amount, TallyType ttype)
     } else {
 
         now64 += amount;
-        mp_token[propertyId].balance[ttype] = now64;
+        record.balance[ttype] = now64;
 
         fUpdated = true;
     }
@@ -107,7 +160,7 @@ int64_t CMPTally::getMoney(uint32_t propertyId, TallyType ttype) const
         return 0;
     }
     int64_t money = 0;
-    TokenMap::const_iterator it = mp_token.find(propertyId);
+    TokenMap::const_iterator it = find(propertyId);
 
     if (it != mp_token.end()) {
         const BalanceRecord& record = it->second;
@@ -128,7 +181,7 @@ int64_t CMPTally::getMoney(uint32_t propertyId, TallyType ttype) const
  */
 int64_t CMPTally::getMoneyAvailable(uint32_t propertyId) const
 {
-    TokenMap::const_iterator it = mp_token.find(propertyId);
+    TokenMap::const_iterator it = find(propertyId);
 
     if (it != mp_token.end()) {
         const BalanceRecord& record = it->second;
@@ -154,7 +207,7 @@ int64_t CMPTally::getMoneyAvailable(uint32_t propertyId) const
 int64_t CMPTally::getMoneyReserved(uint32_t propertyId) const
 {
     int64_t money = 0;
-    TokenMap::const_iterator it = mp_token.find(propertyId);
+    TokenMap::const_iterator it = find(propertyId);
 
     if (it != mp_token.end()) {
         const BalanceRecord& record = it->second;
@@ -177,28 +230,21 @@ bool CMPTally::operator==(const CMPTally& rhs) const
     if (mp_token.size() != rhs.mp_token.size()) {
         return false;
     }
-    TokenMap::const_iterator pc1 = mp_token.begin();
-    TokenMap::const_iterator pc2 = rhs.mp_token.begin();
 
-    for (unsigned int i = 0; i < mp_token.size(); ++i) {
-        if (pc1->first != pc2->first) {
+    for (size_t i = 0; i < mp_token.size(); ++i) {
+        if (mp_token[i].first != rhs.mp_token[i].first) {
             return false;
         }
-        const BalanceRecord& record1 = pc1->second;
-        const BalanceRecord& record2 = pc2->second;
+        const BalanceRecord& record1 = mp_token[i].second;
+        const BalanceRecord& record2 = rhs.mp_token[i].second;
 
         for (int ttype = 0; ttype < TALLY_TYPE_COUNT; ++ttype) {
             if (record1.balance[ttype] != record2.balance[ttype]) {
                 return false;
             }
         }
-        ++pc1;
-        ++pc2;
     }
 
-    assert(pc1 == mp_token.end());
-    assert(pc2 == rhs.mp_token.end());
-
     return true;
 }
 
@@ -228,7 +274,7 @@ int64_t CMPTally::print(uint32_t propertyId, bool bDivisible) const
     int64_t pending = 0;
     int64_t metadex_reserve = 0;
 
-    TokenMap::const_iterator it = mp_token.find(propertyId);
+    TokenMap::const_iterator it = find(propertyId);
 
     if (it != mp_token.end()) {
         const BalanceRecord& record = it->second;
@@ -251,3 +297,13 @@ int64_t CMPTally::print(uint32_t propertyId, bool bDivisible) const
 
     return (balance + selloffer_reserve + accept_reserve + metadex_reserve);
 }
+
+/**
+ * Returns the heap memory used by the balance records.
+ *
+ * @return The number of bytes allocated for the tally
+ */
+size_t CMPTally::DynamicMemoryUsage() const
+{
+    return memusage::DynamicUsage(mp_token);
+}
@@ -1,8 +1,10 @@
 #ifndef ELYSIUM_TALLY_H
 #define ELYSIUM_TALLY_H
 
+#include <stddef.h>
 #include <stdint.h>
-#include <map>
+#include <utility>
+#include <vector>
 
 //! Balance record types
 enum TallyType {
@@ -23,12 +25,23 @@ private:
         int64_t balance[TALLY_TYPE_COUNT];
     } BalanceRecord;
 
-    //! Map of balance records
-    typedef std::map<uint32_t, BalanceRecord> TokenMap;
+    /**
+     * Balance records, sorted by property identifier.
+     *
+     * Most entities only hold a few tokens, so the records are stored next
+     * to each other instead of in separately allocated tree nodes.
+     */
+    typedef std::vector<std::pair<uint32_t, BalanceRecord> > TokenMap;
     //! Balance records for different tokens
     TokenMap mp_token;
-    //! Internal iterator pointing to a balance record
-    TokenMap::iterator my_it;
+    //! Position of the internal iterator
+    size_t my_pos;
+
+    /** Returns the balance record of the token, or end(), if there is none. */
+    TokenMap::const_iterator find(uint32_t propertyId) const;
+
+    /** Returns the balance record of the token and inserts an empty one, if there is none. */
+    BalanceRecord& lookupOrInsert(uint32_t propertyId);
 
 public:
     /** Creates an empty tally. */
@@ -60,6 +73,12 @@ public:
 
     /** Prints a balance record to the console. */
     int64_t print(uint32_t propertyId = 1, bool bDivisible = true) const;
+
+    /** Returns the number of balance records. */
+    size_t size() const { return mp_token.size(); }
+
+    /** Returns the heap memory used by the balance records. */
+    size_t DynamicMemoryUsage() const;
 };
 
 
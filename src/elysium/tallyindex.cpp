@@ -0,0 +1,76 @@
+#include "elysium/tallyindex.h"
+
+#include <stdint.h>
+
+#include <set>
+#include <string>
+
+/**
+ * Records the change of the holdings of an address.
+ *
+ * The address is added to the holders of the property, when it had no tokens before, and removed, when all
+ * of its tokens are gone.
+ */
+void CMPTallyIndex::Update(const std::string& address, uint32_t propertyId, int64_t before, int64_t after)
+{
+    if (before == after) {
+        return;
+    }
+
+    PropertyRecord& record = properties[propertyId];
+    record.total += after - before;
+
+    if (before == 0) {
+        record.holders.insert(address);
+    } else if (after == 0) {
+        record.holders.erase(address);
+    }
+}
+
+/**
+ * Returns the sum of the holdings of all addresses.
+ */
+int64_t CMPTallyIndex::GetTotal(uint32_t propertyId) const
+{
+    auto it = properties.find(propertyId);
+    if (it == properties.end()) {
+        return 0;
+    }
+    return it->second.total;
+}
+
+/**
+ * Returns the number of addresses with non-zero holdings.
+ */
+size_t CMPTallyIndex::GetHolderCount(uint32_t propertyId) const
+{
+    auto it = properties.find(propertyId);
+    if (it == properties.end()) {
+        return 0;
+    }
+    return it->second.holders.size();
+}
+
+/**
+ * Returns the addresses with non-zero holdings.
+ *
+ * The reference is invalidated by the next call of Update() or Clear().
+ */
+const std::set<std::string>& CMPTallyIndex::GetHolders(uint32_t propertyId) const
+{
+    static const std::set<std::string> empty;
+
+    auto it = properties.find(propertyId);
+    if (it == properties.end()) {
+        return empty;
+    }
+    return it->second.holders;
+}
+
+/**
+ * Removes all records.
+ */
+void CMPTallyIndex::Clear()
+{
+    properties.clear();
+}
@@ -0,0 +1,43 @@
+#ifndef ELYSIUM_TALLYINDEX_H
+#define ELYSIUM_TALLYINDEX_H
+
+#include <stdint.h>
+
+#include <set>
+#include <string>
+#include <unordered_map>
+
+/** Running totals and holders of every property.
+ *
+ * The holdings of an address are the sum of its balance and the amounts reserved by sell offers, accepts and
+ * MetaDEx offers; pending amounts are not included. The index is kept in sync by update_tally_map(), so that
+ * the total number of tokens or the holders of a property don't require to scan the whole tally map.
+ */
+class CMPTallyIndex
+{
+private:
+    struct PropertyRecord {
+        int64_t total = 0;
+        std::set<std::string> holders;
+    };
+
+    std::unordered_map<uint32_t, PropertyRecord> properties;
+
+public:
+    /** Records the change of the holdings of an address from before to after. */
+    void Update(const std::string& address, uint32_t propertyId, int64_t before, int64_t after);
+
+    /** Returns the sum of the holdings of all addresses. */
+    int64_t GetTotal(uint32_t propertyId) const;
+
+    /** Returns the number of addresses with non-zero holdings. */
+    size_t GetHolderCount(uint32_t propertyId) const;
+
+    /** Returns the addresses with non-zero holdings, ordered by address. */
+    const std::set<std::string>& GetHolders(uint32_t propertyId) const;
+
+    /** Removes all records. */
+    void Clear();
+};
+
+#endif // ELYSIUM_TALLYINDEX_H
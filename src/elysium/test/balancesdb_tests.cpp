@@ -0,0 +1,112 @@
+#include "../balancesdb.h"
+
+#include "../../test/test_bitcoin.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace elysium {
+namespace {
+
+BalanceEntry MakeEntry(const std::string& address, uint32_t propertyId, int64_t balance, int64_t metaDExReserve = 0)
+{
+    BalanceEntry entry;
+    entry.address = address;
+    entry.propertyId = propertyId;
+    entry.balance = balance;
+    entry.metaDExReserve = metaDExReserve;
+    return entry;
+}
+
+std::map<std::pair<std::string, uint32_t>, int64_t> GetBalances(const CElysiumBalancesDB& db)
+{
+    std::map<std::pair<std::string, uint32_t>, int64_t> balances;
+    BOOST_CHECK(db.ForEachBalance([&balances](const BalanceEntry& entry) {
+        balances[std::make_pair(entry.address, entry.propertyId)] = entry.balance + entry.metaDExReserve;
+    }));
+    return balances;
+}
+
+class BalancesDbTestingSetup : public TestingSetup
+{
+public:
+    BalancesDbTestingSetup() : TestingSetup(CBaseChainParams::REGTEST)
+    {
+    }
+};
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(elysium_balancesdb_tests, BalancesDbTestingSetup)
+
+BOOST_AUTO_TEST_CASE(write_and_roll_back)
+{
+    CElysiumBalancesDB db(pathTemp / "ELYSIUM_balances_test", true);
+
+    int block;
+    uint256 blockHash;
+    BOOST_CHECK(!db.GetWatermark(block, blockHash));
+
+    uint256 hash1 = uint256S("01");
+    uint256 hash2 = uint256S("02");
+    uint256 hash3 = uint256S("03");
+
+    BOOST_CHECK(db.WriteBlock(1, hash1, {MakeEntry("a", 3, 100), MakeEntry("b", 3, 50)}));
+    BOOST_CHECK(db.WriteBlock(2, hash2, {MakeEntry("a", 3, 60), MakeEntry("c", 3, 40)}));
+    BOOST_CHECK(db.WriteBlock(3, hash3, {MakeEntry("b", 3, 0), MakeEntry("c", 3, 30, 10), MakeEntry("c", 4, 7)}));
+
+    BOOST_CHECK(db.GetWatermark(block, blockHash));
+    BOOST_CHECK_EQUAL(block, 3);
+    BOOST_CHECK(blockHash == hash3);
+
+    auto balances = GetBalances(db);
+    BOOST_CHECK_EQUAL(balances.size(), 3);
+    BOOST_CHECK_EQUAL(balances[std::make_pair(std::string("a"), 3)], 60);
+    BOOST_CHECK_EQUAL(balances[std::make_pair(std::string("c"), 3)], 40);
+    BOOST_CHECK_EQUAL(balances[std::make_pair(std::string("c"), 4)], 7);
+
+    // a different block at the same height doesn't match
+    BOOST_CHECK(!db.RollBack(1, hash2));
+
+    BOOST_CHECK(db.RollBack(1, hash1));
+    BOOST_CHECK(db.GetWatermark(block, blockHash));
+    BOOST_CHECK_EQUAL(block, 1);
+    BOOST_CHECK(blockHash == hash1);
+
+    balances = GetBalances(db);
+    BOOST_CHECK_EQUAL(balances.size(), 2);
+    BOOST_CHECK_EQUAL(balances[std::make_pair(std::string("a"), 3)], 100);
+    BOOST_CHECK_EQUAL(balances[std::make_pair(std::string("b"), 3)], 50);
+}
+
+BOOST_AUTO_TEST_CASE(snapshot_limits_roll_back)
+{
+    CElysiumBalancesDB db(pathTemp / "ELYSIUM_balances_test", true);
+
+    uint256 hash5 = uint256S("05");
+    uint256 hash6 = uint256S("06");
+
+    BOOST_CHECK(db.WriteBlock(4, uint256S("04"), {MakeEntry("a", 3, 1)}));
+    BOOST_CHECK(db.WriteSnapshot(5, hash5, {MakeEntry("b", 3, 20), MakeEntry("c", 3, 0)}));
+    BOOST_CHECK(db.WriteBlock(6, hash6, {MakeEntry("b", 3, 25)}));
+
+    auto balances = GetBalances(db);
+    BOOST_CHECK_EQUAL(balances.size(), 1);
+    BOOST_CHECK_EQUAL(balances[std::make_pair(std::string("b"), 3)], 25);
+
+    // the state before the snapshot is gone
+    BOOST_CHECK(!db.RollBack(4, uint256S("04")));
+
+    BOOST_CHECK(db.RollBack(5, hash5));
+    balances = GetBalances(db);
+    BOOST_CHECK_EQUAL(balances.size(), 1);
+    BOOST_CHECK_EQUAL(balances[std::make_pair(std::string("b"), 3)], 20);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace elysium
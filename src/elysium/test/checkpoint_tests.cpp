@@ -30,6 +30,28 @@ extern void clear_all_state();
 
 using namespace elysium;
 
+namespace {
+
+struct ConsensusHashTestingSetup : public TestingSetup
+{
+    ConsensusHashTestingSetup()
+    {
+        _my_sps = new CMPSPInfo(pathTemp / "MP_spinfo_test", false);
+    }
+
+    ~ConsensusHashTestingSetup()
+    {
+        LOCK(cs_main);
+        mp_tally_map.clear();
+        mp_tally_index.Clear();
+        ClearConsensusHashCache();
+        delete _my_sps;
+        _my_sps = nullptr;
+    }
+};
+
+} // namespace
+
 BOOST_FIXTURE_TEST_SUITE(elysium_checkpoint_tests, BasicTestingSetup)
 
 BOOST_AUTO_TEST_CASE(consensus_string_tally)
@@ -98,4 +120,40 @@ BOOST_AUTO_TEST_CASE(consensus_string_property_issuer)
             GenerateConsensusString(5, "3CwZ7FiQ4MqBenRdCkjjc41M5bnoKQGC2b"));
 }
 
+BOOST_FIXTURE_TEST_CASE(consensus_hash_balance_updates, ConsensusHashTestingSetup)
+{
+    LOCK(cs_main);
+    mp_tally_map.clear();
+    mp_tally_index.Clear();
+    ClearConsensusHashCache();
+
+    BOOST_CHECK(update_tally_map("1HG3s4Ext3sTqBTHrgftyUzG3cvx5ZbPCj", 1, 100, BALANCE));
+    BOOST_CHECK(update_tally_map("3CwZ7FiQ4MqBenRdCkjjc41M5bnoKQGC2b", 3, 50, BALANCE));
+    BOOST_CHECK(update_tally_map("3CwZ7FiQ4MqBenRdCkjjc41M5bnoKQGC2b", 1, 20, BALANCE));
+
+    // builds the cache
+    uint256 hashBefore = GetConsensusHash();
+    ClearConsensusHashCache();
+    BOOST_CHECK_EQUAL(hashBefore.GetHex(), GetConsensusHash().GetHex());
+
+    // empty a balance, add a new address and a new property of a known address, change a reserve
+    BOOST_CHECK(update_tally_map("1HG3s4Ext3sTqBTHrgftyUzG3cvx5ZbPCj", 1, -100, BALANCE));
+    BOOST_CHECK(update_tally_map("1PxejjeWZc9ZHph7A3SYDo2sk2Up4AcysH", 5, 7, BALANCE));
+    BOOST_CHECK(update_tally_map("3CwZ7FiQ4MqBenRdCkjjc41M5bnoKQGC2b", 4, 1, BALANCE));
+    BOOST_CHECK(update_tally_map("3CwZ7FiQ4MqBenRdCkjjc41M5bnoKQGC2b", 3, 10, METADEX_RESERVE));
+
+    // the cached hash matches the one built from the whole tally map
+    uint256 hashAfter = GetConsensusHash();
+    BOOST_CHECK(hashAfter != hashBefore);
+    ClearConsensusHashCache();
+    BOOST_CHECK_EQUAL(hashAfter.GetHex(), GetConsensusHash().GetHex());
+
+    // and returns to the previous hash when the changes are undone
+    BOOST_CHECK(update_tally_map("1HG3s4Ext3sTqBTHrgftyUzG3cvx5ZbPCj", 1, 100, BALANCE));
+    BOOST_CHECK(update_tally_map("1PxejjeWZc9ZHph7A3SYDo2sk2Up4AcysH", 5, -7, BALANCE));
+    BOOST_CHECK(update_tally_map("3CwZ7FiQ4MqBenRdCkjjc41M5bnoKQGC2b", 4, -1, BALANCE));
+    BOOST_CHECK(update_tally_map("3CwZ7FiQ4MqBenRdCkjjc41M5bnoKQGC2b", 3, -10, METADEX_RESERVE));
+    BOOST_CHECK_EQUAL(hashBefore.GetHex(), GetConsensusHash().GetHex());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
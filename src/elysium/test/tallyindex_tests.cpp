@@ -0,0 +1,58 @@
+#include "elysium/tallyindex.h"
+
+#include "test/test_bitcoin.h"
+
+#include <stdint.h>
+
+#include <set>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(elysium_tallyindex_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(empty_index)
+{
+    CMPTallyIndex index;
+    BOOST_CHECK_EQUAL(0, index.GetTotal(1));
+    BOOST_CHECK_EQUAL(0, index.GetHolderCount(1));
+    BOOST_CHECK(index.GetHolders(1).empty());
+}
+
+BOOST_AUTO_TEST_CASE(holders_and_totals)
+{
+    CMPTallyIndex index;
+
+    index.Update("a", 3, 0, 100);
+    index.Update("b", 3, 0, 50);
+    index.Update("a", 4, 0, 7);
+    BOOST_CHECK_EQUAL(150, index.GetTotal(3));
+    BOOST_CHECK_EQUAL(2, index.GetHolderCount(3));
+    BOOST_CHECK_EQUAL(7, index.GetTotal(4));
+    BOOST_CHECK_EQUAL(1, index.GetHolderCount(4));
+
+    // moving tokens between holders keeps the total
+    index.Update("a", 3, 100, 60);
+    index.Update("c", 3, 0, 40);
+    BOOST_CHECK_EQUAL(150, index.GetTotal(3));
+    BOOST_CHECK_EQUAL(3, index.GetHolderCount(3));
+
+    // unchanged holdings are ignored
+    index.Update("d", 3, 0, 0);
+    BOOST_CHECK_EQUAL(3, index.GetHolderCount(3));
+
+    // spending everything removes the holder
+    index.Update("b", 3, 50, 0);
+    BOOST_CHECK_EQUAL(100, index.GetTotal(3));
+    BOOST_CHECK_EQUAL(2, index.GetHolderCount(3));
+
+    std::set<std::string> expected = {"a", "c"};
+    BOOST_CHECK(index.GetHolders(3) == expected);
+
+    index.Clear();
+    BOOST_CHECK_EQUAL(0, index.GetTotal(3));
+    BOOST_CHECK_EQUAL(0, index.GetHolderCount(4));
+    BOOST_CHECK(index.GetHolders(3).empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
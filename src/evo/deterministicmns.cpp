@@ -590,6 +590,7 @@ bool CDeterministicMNManager::UndoBlock(const CBlock& block, const CBlockIndex*
         evoDb.Erase(std::make_pair(DB_LIST_SNAPSHOT, blockHash));
 
         mnListsCache.erase(blockHash);
+        mnListsHistoricCache.erase(blockHash);
     }
 
     if (diff.HasChanges()) {
@@ -909,16 +910,19 @@ CDeterministicMNList CDeterministicMNManager::GetListForBlock(const CBlockIndex*
             snapshot = it->second;
             break;
         }
+        if (mnListsHistoricCache.get(pindex->GetBlockHash(), snapshot)) {
+            break;
+        }
 
         if (evoDb.Read(std::make_pair(DB_LIST_SNAPSHOT, pindex->GetBlockHash()), snapshot)) {
-            mnListsCache.emplace(pindex->GetBlockHash(), snapshot);
+            CacheList(pindex, snapshot, true);
             break;
         }
 
         CDeterministicMNListDiff diff;
         if (!evoDb.Read(std::make_pair(DB_LIST_DIFF, pindex->GetBlockHash()), diff)) {
             snapshot = CDeterministicMNList(pindex->GetBlockHash(), -1, 0);
-            mnListsCache.emplace(pindex->GetBlockHash(), snapshot);
+            CacheList(pindex, snapshot, true);
             break;
         }
 
@@ -936,7 +940,7 @@ CDeterministicMNList CDeterministicMNManager::GetListForBlock(const CBlockIndex*
             snapshot.SetHeight(diffIndex->nHeight);
         }
 
-        mnListsCache.emplace(diffIndex->GetBlockHash(), snapshot);
+        CacheList(diffIndex, snapshot, diffIndex == listDiff.back().first);
     }
 
     return snapshot;
@@ -984,6 +988,18 @@ bool CDeterministicMNManager::IsDIP3Enforced(int nHeight)
     return nHeight >= Params().GetConsensus().DIP0003EnforcementHeight;
 }
 
+void CDeterministicMNManager::CacheList(const CBlockIndex* pindex, const CDeterministicMNList& mnList, bool fForceHistoric)
+{
+    AssertLockHeld(cs);
+
+    // without a tip (e.g. while loading) everything is treated as recent
+    if (!tipIndex || pindex->nHeight + LISTS_CACHE_SIZE >= tipIndex->nHeight) {
+        mnListsCache.emplace(pindex->GetBlockHash(), mnList);
+    } else if (fForceHistoric || (pindex->nHeight % HISTORIC_LISTS_CACHE_INTERVAL) == 0) {
+        mnListsHistoricCache.insert(pindex->GetBlockHash(), mnList);
+    }
+}
+
 void CDeterministicMNManager::CleanupCache(int nHeight)
 {
     AssertLockHeld(cs);
@@ -992,6 +1008,10 @@ void CDeterministicMNManager::CleanupCache(int nHeight)
     for (const auto& p : mnListsCache) {
         if (p.second.GetHeight() + LISTS_CACHE_SIZE < nHeight) {
             toDelete.emplace_back(p.first);
+            // keep some of the lists leaving the window around for queries of older blocks
+            if ((p.second.GetHeight() % HISTORIC_LISTS_CACHE_INTERVAL) == 0) {
+                mnListsHistoricCache.insert(p.first, p.second);
+            }
         }
     }
     for (const auto& h : toDelete) {
@@ -10,8 +10,10 @@
 #include "dbwrapper.h"
 #include "evodb.h"
 #include "providertx.h"
+#include "saltedhasher.h"
 #include "simplifiedmns.h"
 #include "sync.h"
+#include "unordered_lru_cache.h"
 
 #include "immer/map.hpp"
 #include "immer/map_transient.hpp"
@@ -625,16 +627,22 @@ public:
 
 class CDeterministicMNManager
 {
+public:
     static const int SNAPSHOT_LIST_PERIOD = 576; // once per day
     static const int LISTS_CACHE_SIZE = 576;
+    // lists older than LISTS_CACHE_SIZE blocks are only kept every HISTORIC_LISTS_CACHE_INTERVAL blocks, so that
+    // repeated queries for old blocks only need to apply a few diffs instead of all diffs since the last snapshot
+    static const int HISTORIC_LISTS_CACHE_INTERVAL = 16;
+    static const int HISTORIC_LISTS_CACHE_SIZE = 256;
 
-public:
     CCriticalSection cs;
 
 private:
     CEvoDB& evoDb;
 
     std::map<uint256, CDeterministicMNList> mnListsCache;
+    // lists share their immer maps, so keeping a few hundred of them is cheap
+    unordered_lru_cache<uint256, CDeterministicMNList, StaticSaltedHasher, HISTORIC_LISTS_CACHE_SIZE> mnListsHistoricCache;
     const CBlockIndex* tipIndex{nullptr};
 
 public:
@@ -665,6 +673,7 @@ public:
     static bool IsDIP3Active(int height);
 
 private:
+    void CacheList(const CBlockIndex* pindex, const CDeterministicMNList& mnList, bool fForceHistoric);
     void CleanupCache(int nHeight);
 };
 
@@ -14,8 +14,15 @@
 #include "base58.h"
 #include "chainparams.h"
 #include "consensus/merkle.h"
+#include "hash.h"
+#include "saltedhasher.h"
 #include "univalue.h"
+#include "unordered_lru_cache.h"
 #include "validation.h"
+#include "version.h"
+
+#include <list>
+#include <unordered_map>
 
 CSimplifiedMNListEntry::CSimplifiedMNListEntry(const CDeterministicMN& dmn) :
     proRegTxHash(dmn.proTxHash),
@@ -185,6 +192,89 @@ void CSimplifiedMNListDiff::ToJson(UniValue& obj) const
     }
 }
 
+// Light clients poll mnlistdiff with the same few base blocks against the tip, so complete diffs are memoized. A diff
+// only depends on the two blocks it was built for, entries never need to be invalidated. Any peer can ask for diffs, and
+// one against a null or old base holds the whole list, so only diffs up to MNLISTDIFF_CACHE_MAX_DEPTH blocks below the
+// tip are kept and the cache is limited by their serialized size. Coinbase and its merkle proof are kept per block to
+// avoid reading the block from disk for every new base block. Both caches are protected by cs_main
+static const int MNLISTDIFF_CACHE_MAX_DEPTH = 8;
+static const size_t MNLISTDIFF_CACHE_MAX_BYTES = 4 * 1024 * 1024;
+
+class CSimplifiedMNListDiffCache
+{
+private:
+    // most recently used first
+    typedef std::list<std::pair<uint256, CSimplifiedMNListDiff>> EntryList;
+
+    EntryList entries;
+    std::unordered_map<uint256, std::pair<EntryList::iterator, size_t>, StaticSaltedHasher> entryMap;
+    size_t nBytes{0};
+
+public:
+    bool Get(const uint256& key, CSimplifiedMNListDiff& diffRet)
+    {
+        auto it = entryMap.find(key);
+        if (it == entryMap.end()) {
+            return false;
+        }
+        entries.splice(entries.begin(), entries, it->second.first);
+        diffRet = it->second.first->second;
+        return true;
+    }
+
+    void Insert(const uint256& key, const CSimplifiedMNListDiff& diff)
+    {
+        // a single diff may take at most a quarter of the cache
+        size_t nSize = ::GetSerializeSize(diff, SER_NETWORK, PROTOCOL_VERSION);
+        if (nSize > MNLISTDIFF_CACHE_MAX_BYTES / 4 || entryMap.count(key)) {
+            return;
+        }
+
+        entries.emplace_front(key, diff);
+        entryMap.emplace(key, std::make_pair(entries.begin(), nSize));
+        nBytes += nSize;
+        while (nBytes > MNLISTDIFF_CACHE_MAX_BYTES) {
+            auto it = entryMap.find(entries.back().first);
+            nBytes -= it->second.second;
+            entryMap.erase(it);
+            entries.pop_back();
+        }
+    }
+};
+
+static CSimplifiedMNListDiffCache mnListDiffCache;
+static unordered_lru_cache<uint256, std::pair<CTransactionRef, CPartialMerkleTree>, StaticSaltedHasher, 64> cbTxProofCache;
+
+static bool GetCbTxWithProof(const CBlockIndex* blockIndex, CTransactionRef& cbTxRet, CPartialMerkleTree& merkleTreeRet)
+{
+    AssertLockHeld(cs_main);
+
+    std::pair<CTransactionRef, CPartialMerkleTree> cached;
+    if (cbTxProofCache.get(blockIndex->GetBlockHash(), cached)) {
+        cbTxRet = cached.first;
+        merkleTreeRet = cached.second;
+        return true;
+    }
+
+    // TODO store coinbase TX in CBlockIndex
+    CBlock block;
+    if (!ReadBlockFromDisk(block, blockIndex, Params().GetConsensus())) {
+        return false;
+    }
+
+    std::vector<uint256> vHashes;
+    std::vector<bool> vMatch(block.vtx.size(), false);
+    for (const auto& tx : block.vtx) {
+        vHashes.emplace_back(tx->GetHash());
+    }
+    vMatch[0] = true; // only coinbase matches
+
+    cbTxRet = block.vtx[0];
+    merkleTreeRet = CPartialMerkleTree(vHashes, vMatch);
+    cbTxProofCache.insert(blockIndex->GetBlockHash(), std::make_pair(cbTxRet, merkleTreeRet));
+    return true;
+}
+
 bool BuildSimplifiedMNListDiff(const uint256& baseBlockHash, const uint256& blockHash, CSimplifiedMNListDiff& mnListDiffRet, std::string& errorRet)
 {
     AssertLockHeld(cs_main);
@@ -215,6 +305,12 @@ bool BuildSimplifiedMNListDiff(const uint256& baseBlockHash, const uint256& bloc
         return false;
     }
 
+    CHashWriter cacheKey(SER_GETHASH, 0);
+    cacheKey << baseBlockHash << blockHash;
+    if (mnListDiffCache.Get(cacheKey.GetHash(), mnListDiffRet)) {
+        return true;
+    }
+
     LOCK(deterministicMNManager->cs);
 
     auto baseDmnList = deterministicMNManager->GetListForBlock(baseBlockIndex);
@@ -231,22 +327,14 @@ bool BuildSimplifiedMNListDiff(const uint256& baseBlockHash, const uint256& bloc
         return false;
     }
 
-    // TODO store coinbase TX in CBlockIndex
-    CBlock block;
-    if (!ReadBlockFromDisk(block, blockIndex, Params().GetConsensus())) {
+    if (!GetCbTxWithProof(blockIndex, mnListDiffRet.cbTx, mnListDiffRet.cbTxMerkleTree)) {
         errorRet = strprintf("failed to read block %s from disk", blockHash.ToString());
         return false;
     }
 
-    mnListDiffRet.cbTx = block.vtx[0];
-
-    std::vector<uint256> vHashes;
-    std::vector<bool> vMatch(block.vtx.size(), false);
-    for (const auto& tx : block.vtx) {
-        vHashes.emplace_back(tx->GetHash());
+    if (chainActive.Height() - blockIndex->nHeight < MNLISTDIFF_CACHE_MAX_DEPTH) {
+        mnListDiffCache.Insert(cacheKey.GetHash(), mnListDiffRet);
     }
-    vMatch[0] = true; // only coinbase matches
-    mnListDiffRet.cbTxMerkleTree = CPartialMerkleTree(vHashes, vMatch);
 
     return true;
 }
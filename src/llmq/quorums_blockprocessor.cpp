@@ -7,6 +7,7 @@
 #include "quorums_debug.h"
 #include "quorums_utils.h"
 
+#include "bls/bls_batchverifier.h"
 #include "evo/specialtx.h"
 
 #include "chain.h"
@@ -155,9 +156,12 @@ bool CQuorumBlockProcessor::ProcessBlock(const CBlock& block, const CBlockIndex*
 
     auto blockHash = block.GetHash();
 
+    std::set<Consensus::LLMQType> verifiedSigs;
+    BatchVerifyCommitments(qcs, verifiedSigs);
+
     for (auto& p : qcs) {
         auto& qc = p.second;
-        if (!ProcessCommitment(pindex->nHeight, blockHash, qc, state)) {
+        if (!ProcessCommitment(pindex->nHeight, blockHash, qc, !verifiedSigs.count(p.first), state)) {
             return false;
         }
     }
@@ -175,7 +179,69 @@ static std::tuple<std::string, uint8_t, uint32_t> BuildInversedHeightKey(Consens
     return std::make_tuple(DB_MINED_COMMITMENT_BY_INVERSED_HEIGHT, (uint8_t)llmqType, htobe32(std::numeric_limits<uint32_t>::max() - nMinedHeight));
 }
 
-bool CQuorumBlockProcessor::ProcessCommitment(int nHeight, const uint256& blockHash, const CFinalCommitment& qc, CValidationState& state)
+// Verifies the signatures of all non-null commitments of a block in a single batch. Each commitment carries two
+// signatures of the same commitment hash, the aggregated members signature and the quorum signature. Secure batch
+// verification is used as the quorum public key is chosen by whoever created the commitment and could otherwise cancel
+// out the members key. Commitments which are not in verifiedSigs afterwards (malformed or failing the batch) are
+// fully re-verified by ProcessCommitment, so the batch never decides on its own to reject a block.
+void CQuorumBlockProcessor::BatchVerifyCommitments(const std::map<Consensus::LLMQType, CFinalCommitment>& qcs, std::set<Consensus::LLMQType>& verifiedSigs)
+{
+    AssertLockHeld(cs_main);
+
+    // message ids are (llmqType, isQuorumSig)
+    CBLSBatchVerifier<Consensus::LLMQType, std::pair<Consensus::LLMQType, bool>> batchVerifier(true, false);
+    std::set<Consensus::LLMQType> pushed;
+
+    for (const auto& p : qcs) {
+        const auto& qc = p.second;
+        if (qc.IsNull()) {
+            continue;
+        }
+
+        auto it = mapBlockIndex.find(qc.quorumHash);
+        if (it == mapBlockIndex.end()) {
+            continue;
+        }
+        auto members = CLLMQUtils::GetAllQuorumMembers(p.first, it->second);
+        if (!qc.Verify(members, false)) {
+            continue;
+        }
+
+        std::vector<CBLSPublicKey> memberPubKeys;
+        for (size_t i = 0; i < members.size(); i++) {
+            if (!qc.signers[i]) {
+                continue;
+            }
+            memberPubKeys.emplace_back(members[i]->pdmnState->pubKeyOperator.Get());
+        }
+        CBLSPublicKey membersPubKey = CBLSPublicKey::AggregateSecure(memberPubKeys);
+        if (!membersPubKey.IsValid()) {
+            continue;
+        }
+
+        uint256 commitmentHash = CLLMQUtils::BuildCommitmentHash(qc.llmqType, qc.quorumHash, qc.validMembers, qc.quorumPublicKey, qc.quorumVvecHash);
+        batchVerifier.PushMessage(p.first, std::make_pair(p.first, false), commitmentHash, qc.membersSig, membersPubKey);
+        batchVerifier.PushMessage(p.first, std::make_pair(p.first, true), commitmentHash, qc.quorumSig, qc.quorumPublicKey);
+        pushed.emplace(p.first);
+    }
+
+    if (pushed.empty()) {
+        return;
+    }
+
+    batchVerifier.Verify();
+
+    for (auto llmqType : pushed) {
+        if (!batchVerifier.badSources.count(llmqType)) {
+            verifiedSigs.emplace(llmqType);
+        }
+    }
+
+    LogPrint("llmq", "CQuorumBlockProcessor::%s -- batch verified %d commitments, %d failed\n", __func__,
+              pushed.size(), batchVerifier.badSources.size());
+}
+
+bool CQuorumBlockProcessor::ProcessCommitment(int nHeight, const uint256& blockHash, const CFinalCommitment& qc, bool checkSigs, CValidationState& state)
 {
     auto& params = Params().GetConsensus().llmqs.at((Consensus::LLMQType)qc.llmqType);
 
@@ -207,7 +273,7 @@ bool CQuorumBlockProcessor::ProcessCommitment(int nHeight, const uint256& blockH
     auto quorumIndex = mapBlockIndex.at(qc.quorumHash);
     auto members = CLLMQUtils::GetAllQuorumMembers(params.type, quorumIndex);
 
-    if (!qc.Verify(members, true)) {
+    if (!qc.Verify(members, checkSigs)) {
         return state.DoS(100, false, REJECT_INVALID, "bad-qc-invalid");
     }
 
@@ -14,6 +14,7 @@
 #include "sync.h"
 
 #include <map>
+#include <set>
 #include <unordered_map>
 
 class CNode;
@@ -58,7 +59,8 @@ public:
 
 private:
     bool GetCommitmentsFromBlock(const CBlock& block, const CBlockIndex* pindex, std::map<Consensus::LLMQType, CFinalCommitment>& ret, CValidationState& state);
-    bool ProcessCommitment(int nHeight, const uint256& blockHash, const CFinalCommitment& qc, CValidationState& state);
+    void BatchVerifyCommitments(const std::map<Consensus::LLMQType, CFinalCommitment>& qcs, std::set<Consensus::LLMQType>& verifiedSigs);
+    bool ProcessCommitment(int nHeight, const uint256& blockHash, const CFinalCommitment& qc, bool checkSigs, CValidationState& state);
     bool IsMiningPhase(Consensus::LLMQType llmqType, int nHeight);
     bool IsCommitmentRequired(Consensus::LLMQType llmqType, int nHeight);
     uint256 GetQuorumBlockHash(Consensus::LLMQType llmqType, int nHeight);
@@ -88,6 +88,15 @@ CDKGMember::CDKGMember(CDeterministicMNCPtr _dmn, size_t _idx) :
 
 }
 
+CDKGSession::~CDKGSession()
+{
+    // the BLS worker still references the inputs of running verifications. Verifications dropped by a stopped worker
+    // never finish, but then nothing references their inputs anymore
+    for (auto& v : runningContributionVerifications) {
+        blsWorker.WaitForResult(v->result);
+    }
+}
+
 bool CDKGSession::Init(const CBlockIndex* _pindexQuorum, const std::vector<CDeterministicMNCPtr>& mns, const uint256& _myProTxHash)
 {
     if (mns.size() < params.minSize) {
@@ -346,8 +355,9 @@ void CDKGSession::ReceiveMessage(const uint256& hash, const CDKGContribution& qc
     }
 
     if (verifyPending) {
-        VerifyPendingContributions();
+        StartPendingContributionsVerification();
     }
+    FinishContributionVerifications(false);
 }
 
 // Verifies all pending secret key contributions in one batch
@@ -357,51 +367,82 @@ void CDKGSession::ReceiveMessage(const uint256& hash, const CDKGContribution& qc
 // See CBLSWorker::VerifyContributionShares for more details.
 void CDKGSession::VerifyPendingContributions()
 {
-    CDKGLogger logger(*this, __func__);
-
-    cxxtimer::Timer t1(true);
+    StartPendingContributionsVerification();
+    FinishContributionVerifications(true);
+}
 
+// Starts verification of the pending contributions on the BLS worker without waiting for the result. Other sessions
+// (of other LLMQ types) verify on the same worker, so their batches overlap with this one
+void CDKGSession::StartPendingContributionsVerification()
+{
     std::vector<size_t> pend = std::move(pendingContributionVerifications);
     if (pend.empty()) {
         return;
     }
 
-    std::vector<size_t> memberIndexes;
-    std::vector<BLSVerificationVectorPtr> vvecs;
-    BLSSecretKeyVector skContributions;
+    std::unique_ptr<RunningContributionVerification> v(new RunningContributionVerification());
 
     for (const auto& idx : pend) {
         auto& m = members[idx];
         if (m->bad || m->weComplain) {
             continue;
         }
-        memberIndexes.emplace_back(idx);
-        vvecs.emplace_back(receivedVvecs[idx]);
-        skContributions.emplace_back(receivedSkContributions[idx]);
+        v->memberIndexes.emplace_back(idx);
+        v->vvecs.emplace_back(receivedVvecs[idx]);
+        v->skContributions.emplace_back(receivedSkContributions[idx]);
     }
-
-    auto result = blsWorker.VerifyContributionShares(myId, vvecs, skContributions);
-    if (result.size() != memberIndexes.size()) {
-        logger.Batch("VerifyContributionShares returned result of size %d but size %d was expected, something is wrong", result.size(), memberIndexes.size());
+    if (v->memberIndexes.empty()) {
         return;
     }
 
-    for (size_t i = 0; i < memberIndexes.size(); i++) {
-        if (!result[i]) {
-            auto& m = members[memberIndexes[i]];
-            logger.Batch("invalid contribution from %s. will complain later", m->dmn->proTxHash.ToString());
-            m->weComplain = true;
-            quorumDKGDebugManager->UpdateLocalMemberStatus(params.type, m->idx, [&](CDKGDebugMemberStatus& status) {
-                status.weComplain = true;
-                return true;
-            });
+    v->result = blsWorker.AsyncVerifyContributionShares(myId, v->vvecs, v->skContributions, true, true);
+    runningContributionVerifications.emplace_back(std::move(v));
+}
+
+// Applies the results of finished contribution verifications in the order they were started, waiting for all of them
+// if fWait is set
+void CDKGSession::FinishContributionVerifications(bool fWait)
+{
+    CDKGLogger logger(*this, __func__);
+
+    while (!runningContributionVerifications.empty()) {
+        auto& v = *runningContributionVerifications.front();
+        if (!fWait && v.result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            break;
+        }
+        if (fWait && !blsWorker.WaitForResult(v.result)) {
+            logger.Batch("BLS worker stopped, dropping %d running contribution verifications", runningContributionVerifications.size());
+            runningContributionVerifications.clear();
+            break;
+        }
+
+        cxxtimer::Timer t1(true);
+        auto result = v.result.get();
+        t1.stop();
+
+        if (result.size() != v.memberIndexes.size()) {
+            logger.Batch("VerifyContributionShares returned result of size %d but size %d was expected, something is wrong", result.size(), v.memberIndexes.size());
         } else {
-            size_t memberIdx = memberIndexes[i];
-            dkgManager.WriteVerifiedSkContribution(params.type, pindexQuorum, members[memberIdx]->dmn->proTxHash, skContributions[i]);
+            for (size_t i = 0; i < v.memberIndexes.size(); i++) {
+                if (!result[i]) {
+                    auto& m = members[v.memberIndexes[i]];
+                    logger.Batch("invalid contribution from %s. will complain later", m->dmn->proTxHash.ToString());
+                    m->weComplain = true;
+                    quorumDKGDebugManager->UpdateLocalMemberStatus(params.type, m->idx, [&](CDKGDebugMemberStatus& status) {
+                        status.weComplain = true;
+                        return true;
+                    });
+                } else {
+                    size_t memberIdx = v.memberIndexes[i];
+                    dkgManager.WriteVerifiedSkContribution(params.type, pindexQuorum, members[memberIdx]->dmn->proTxHash, v.skContributions[i]);
+                }
+            }
+
+            logger.Batch("verified %d pending contributions. waited=%d", v.memberIndexes.size(), t1.count());
         }
-    }
 
-    logger.Batch("verified %d pending contributions. time=%d", pend.size(), t1.count());
+        runningContributionVerifications.pop_front();
+    }
 }
 
 void CDKGSession::VerifyAndComplain(CDKGPendingMessages& pendingMessages)
@@ -16,8 +16,13 @@
 
 #include "llmq/quorums_utils.h"
 
+#include <future>
+#include <list>
+
 class UniValue;
 
+namespace llmq_dkgsession_tests { struct dkgsession_destroy_after_worker_stop; }
+
 namespace llmq
 {
 
@@ -241,6 +246,7 @@ class CDKGSession
     friend class CDKGSessionManager;
     friend class CDKGLogger;
     template<typename Message> friend class CDKGMessageHandler;
+    friend struct llmq_dkgsession_tests::dkgsession_destroy_after_worker_stop;
 
 private:
     const Consensus::LLMQParams& params;
@@ -279,12 +285,23 @@ private:
 
     std::vector<size_t> pendingContributionVerifications;
 
+    // Batches of contributions being verified on the BLS worker while the session keeps receiving contributions. The
+    // inputs are owned here as the worker only keeps references to them
+    struct RunningContributionVerification {
+        std::vector<size_t> memberIndexes;
+        std::vector<BLSVerificationVectorPtr> vvecs;
+        BLSSecretKeyVector skContributions;
+        std::future<std::vector<bool>> result;
+    };
+    std::list<std::unique_ptr<RunningContributionVerification>> runningContributionVerifications;
+
     // filled by ReceivePrematureCommitment and used by FinalizeCommitments
     std::set<uint256> validCommitments;
 
 public:
     CDKGSession(const Consensus::LLMQParams& _params, CBLSWorker& _blsWorker, CDKGSessionManager& _dkgManager) :
         params(_params), blsWorker(_blsWorker), cache(_blsWorker), dkgManager(_dkgManager) {}
+    ~CDKGSession();
 
     bool Init(const CBlockIndex* pindexQuorum, const std::vector<CDeterministicMNCPtr>& mns, const uint256& _myProTxHash);
 
@@ -309,6 +326,8 @@ public:
     bool PreVerifyMessage(const uint256& hash, const CDKGContribution& qc, bool& retBan) const;
     void ReceiveMessage(const uint256& hash, const CDKGContribution& qc, bool& retBan);
     void VerifyPendingContributions();
+    void StartPendingContributionsVerification();
+    void FinishContributionVerifications(bool fWait);
 
     // Phase 2: complaint
     void VerifyAndComplain(CDKGPendingMessages& pendingMessages);
@@ -127,44 +127,44 @@ void CRecoveredSigsDb::AddVoteTimeKeys()
 
 bool CRecoveredSigsDb::HasRecoveredSig(Consensus::LLMQType llmqType, const uint256& id, const uint256& msgHash)
 {
-    auto k = std::make_tuple(std::string("rs_r"), (uint8_t)llmqType, id, msgHash);
-    return db.Exists(k);
+    // the "rs_r" entries for (llmqType, id) and (llmqType, id, msgHash) are always written and erased together
+    uint256 recMsgHash = GetMsgHashForId(llmqType, id);
+    return !recMsgHash.IsNull() && recMsgHash == msgHash;
 }
 
 bool CRecoveredSigsDb::HasRecoveredSigForId(Consensus::LLMQType llmqType, const uint256& id)
+{
+    return !GetMsgHashForId(llmqType, id).IsNull();
+}
+
+uint256 CRecoveredSigsDb::GetMsgHashForId(Consensus::LLMQType llmqType, const uint256& id)
 {
     auto cacheKey = std::make_pair(llmqType, id);
-    bool ret;
-    {
-        LOCK(cs);
-        if (hasSigForIdCache.get(cacheKey, ret)) {
-            return ret;
-        }
+    uint256 ret;
+    if (msgHashForIdCache.get(cacheKey, ret)) {
+        return ret;
     }
 
+    // the signature itself is deserialized lazily, so this is not much more expensive than an Exists() check
+    CRecoveredSig recSig;
+    if (ReadRecoveredSig(llmqType, id, recSig)) {
+        ret = recSig.msgHash;
+    }
 
-    auto k = std::make_tuple(std::string("rs_r"), (uint8_t)llmqType, id);
-    ret = db.Exists(k);
-
-    LOCK(cs);
-    hasSigForIdCache.insert(cacheKey, ret);
+    msgHashForIdCache.insert(cacheKey, ret);
     return ret;
 }
 
 bool CRecoveredSigsDb::HasRecoveredSigForSession(const uint256& signHash)
 {
     bool ret;
-    {
-        LOCK(cs);
-        if (hasSigForSessionCache.get(signHash, ret)) {
-            return ret;
-        }
+    if (hasSigForSessionCache.get(signHash, ret)) {
+        return ret;
     }
 
     auto k = std::make_tuple(std::string("rs_s"), signHash);
     ret = db.Exists(k);
 
-    LOCK(cs);
     hasSigForSessionCache.insert(signHash, ret);
     return ret;
 }
@@ -172,17 +172,13 @@ bool CRecoveredSigsDb::HasRecoveredSigForSession(const uint256& signHash)
 bool CRecoveredSigsDb::HasRecoveredSigForHash(const uint256& hash)
 {
     bool ret;
-    {
-        LOCK(cs);
-        if (hasSigForHashCache.get(hash, ret)) {
-            return ret;
-        }
+    if (hasSigForHashCache.get(hash, ret)) {
+        return ret;
     }
 
     auto k = std::make_tuple(std::string("rs_h"), hash);
     ret = db.Exists(k);
 
-    LOCK(cs);
     hasSigForHashCache.insert(hash, ret);
     return ret;
 }
@@ -249,14 +245,9 @@ void CRecoveredSigsDb::WriteRecoveredSig(const llmq::CRecoveredSig& recSig)
 
     db.WriteBatch(batch);
 
-    {
-        int64_t t = GetTimeMillis();
-
-        LOCK(cs);
-        hasSigForIdCache.insert(std::make_pair((Consensus::LLMQType)recSig.llmqType, recSig.id), true);
-        hasSigForSessionCache.insert(signHash, true);
-        hasSigForHashCache.insert(recSig.GetHash(), true);
-    }
+    msgHashForIdCache.insert(std::make_pair((Consensus::LLMQType)recSig.llmqType, recSig.id), recSig.msgHash);
+    hasSigForSessionCache.insert(signHash, true);
+    hasSigForHashCache.insert(recSig.GetHash(), true);
 }
 
 void CRecoveredSigsDb::RemoveRecoveredSig(CDBBatch& batch, Consensus::LLMQType llmqType, const uint256& id, bool deleteTimeKey)
@@ -290,7 +281,7 @@ void CRecoveredSigsDb::RemoveRecoveredSig(CDBBatch& batch, Consensus::LLMQType l
         }
     }
 
-    hasSigForIdCache.erase(std::make_pair((Consensus::LLMQType)recSig.llmqType, recSig.id));
+    msgHashForIdCache.erase(std::make_pair((Consensus::LLMQType)recSig.llmqType, recSig.id));
     hasSigForSessionCache.erase(signHash);
     hasSigForHashCache.erase(recSig.GetHash());
 }
@@ -357,6 +348,22 @@ void CRecoveredSigsDb::CleanupOldRecoveredSigs(int64_t maxAge)
     LogPrint("llmq", "CRecoveredSigsDb::%d -- deleted %d entries\n", __func__, toDelete.size());
 }
 
+UniValue CRecoveredSigsDb::GetCacheStats() const
+{
+    auto cacheToJson = [](uint64_t hits, uint64_t misses) {
+        UniValue ret(UniValue::VOBJ);
+        ret.push_back(Pair("hits", hits));
+        ret.push_back(Pair("misses", misses));
+        return ret;
+    };
+
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("id", cacheToJson(msgHashForIdCache.hit_count(), msgHashForIdCache.miss_count())));
+    ret.push_back(Pair("session", cacheToJson(hasSigForSessionCache.hit_count(), hasSigForSessionCache.miss_count())));
+    ret.push_back(Pair("hash", cacheToJson(hasSigForHashCache.hit_count(), hasSigForHashCache.miss_count())));
+    return ret;
+}
+
 bool CRecoveredSigsDb::HasVotedOnId(Consensus::LLMQType llmqType, const uint256& id)
 {
     auto k = std::make_tuple(std::string("rs_v"), (uint8_t)llmqType, id);
@@ -861,6 +868,11 @@ bool CSigningManager::GetVoteForId(Consensus::LLMQType llmqType, const uint256&
     return db.GetVoteForId(llmqType, id, msgHashRet);
 }
 
+UniValue CSigningManager::GetCacheStats() const
+{
+    return db.GetCacheStats();
+}
+
 std::vector<CQuorumCPtr> CSigningManager::GetActiveQuorumSet(Consensus::LLMQType llmqType, int signHeight)
 {
     auto& llmqParams = Params().GetConsensus().llmqs.at(llmqType);
@@ -11,7 +11,7 @@
 #include "chainparams.h"
 #include "saltedhasher.h"
 #include "univalue.h"
-#include "unordered_lru_cache.h"
+#include "sharded_lru_cache.h"
 
 #include <unordered_map>
 
@@ -66,14 +66,19 @@ class CRecoveredSigsDb
 private:
     CDBWrapper& db;
 
+    // serializes removals, the caches below are thread safe on their own
     CCriticalSection cs;
-    unordered_lru_cache<std::pair<Consensus::LLMQType, uint256>, bool, StaticSaltedHasher, 30000> hasSigForIdCache;
-    unordered_lru_cache<uint256, bool, StaticSaltedHasher, 30000> hasSigForSessionCache;
-    unordered_lru_cache<uint256, bool, StaticSaltedHasher, 30000> hasSigForHashCache;
+
+    // msgHash of the recovered sig for an id, null if there is none. Also answers HasRecoveredSig and IsConflicting
+    sharded_lru_cache<std::pair<Consensus::LLMQType, uint256>, uint256, StaticSaltedHasher, 2000> msgHashForIdCache;
+    sharded_lru_cache<uint256, bool, StaticSaltedHasher, 2000> hasSigForSessionCache;
+    sharded_lru_cache<uint256, bool, StaticSaltedHasher, 2000> hasSigForHashCache;
 
 public:
     CRecoveredSigsDb(CDBWrapper& _db);
 
+    UniValue GetCacheStats() const;
+
     void ConvertInvalidTimeKeys();
     void AddVoteTimeKeys();
 
@@ -96,6 +101,7 @@ public:
     void CleanupOldVotes(int64_t maxAge);
 
 private:
+    uint256 GetMsgHashForId(Consensus::LLMQType llmqType, const uint256& id);
     bool ReadRecoveredSig(Consensus::LLMQType llmqType, const uint256& id, CRecoveredSig& ret);
     void RemoveRecoveredSig(CDBBatch& batch, Consensus::LLMQType llmqType, const uint256& id, bool deleteTimeKey);
 };
@@ -177,6 +183,8 @@ public:
     bool HasVotedOnId(Consensus::LLMQType llmqType, const uint256& id);
     bool GetVoteForId(Consensus::LLMQType llmqType, const uint256& id, uint256& msgHashRet);
 
+    UniValue GetCacheStats() const;
+
     std::vector<CQuorumCPtr> GetActiveQuorumSet(Consensus::LLMQType llmqType, int signHeight);
     CQuorumCPtr SelectQuorumForSigning(Consensus::LLMQType llmqType, int signHeight, const uint256& selectionHash);
 
@@ -15,6 +15,8 @@
 
 #include "cxxtimer.hpp"
 
+#include <future>
+
 namespace llmq
 {
 
@@ -180,6 +182,35 @@ void CSigSharesNodeState::RemoveSession(const uint256& signHash)
     pendingIncomingSigShares.EraseAllForSignHash(signHash);
 }
 
+void CSigSharesLatencyHistogram::Add(int64_t ms)
+{
+    size_t bucket = 0;
+    while (bucket < BUCKET_COUNT - 1 && ms >= ((int64_t)1 << bucket)) {
+        bucket++;
+    }
+    buckets[bucket]++;
+    count++;
+    totalMs += (uint64_t)std::max(ms, (int64_t)0);
+}
+
+UniValue CSigSharesLatencyHistogram::ToJson() const
+{
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("count", count));
+    ret.push_back(Pair("totalMs", totalMs));
+    UniValue histogram(UniValue::VARR);
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        UniValue bucket(UniValue::VOBJ);
+        if (i < BUCKET_COUNT - 1) {
+            bucket.push_back(Pair("belowMs", (int64_t)1 << i));
+        }
+        bucket.push_back(Pair("count", buckets[i]));
+        histogram.push_back(bucket);
+    }
+    ret.push_back(Pair("histogram", histogram));
+    return ret;
+}
+
 //////////////////////
 
 CSigSharesManager::CSigSharesManager()
@@ -198,6 +229,9 @@ void CSigSharesManager::StartWorkerThread()
         assert(false);
     }
 
+    workerPool.resize(std::max(1, std::min((int)std::thread::hardware_concurrency() / 2, 4)));
+    RenameThreadPool(workerPool, "dash-q-sigshares");
+
     workThread = std::thread(&TraceThread<std::function<void()> >,
         "sigshares",
         std::function<void()>(std::bind(&CSigSharesManager::WorkThreadMain, this)));
@@ -213,6 +247,9 @@ void CSigSharesManager::StopWorkerThread()
     if (workThread.joinable()) {
         workThread.join();
     }
+
+    workerPool.clear_queue();
+    workerPool.stop(true);
 }
 
 void CSigSharesManager::RegisterAsRecoveredSigsListener()
@@ -458,10 +495,24 @@ bool CSigSharesManager::ProcessMessageBatchedSigShares(CNode* pfrom, const CBatc
         return true;
     }
 
-    LOCK(cs);
-    auto& nodeState = nodeStates[pfrom->id];
-    for (auto& s : sigShares) {
-        nodeState.pendingIncomingSigShares.Add(s.GetKey(), s);
+    size_t dropped = 0;
+    {
+        LOCK(cs);
+        auto& nodeState = nodeStates[pfrom->id];
+        for (auto& s : sigShares) {
+            if (nodeState.pendingIncomingSigShares.Size() >= MAX_PENDING_SIG_SHARES_PER_NODE) {
+                dropped++;
+                continue;
+            }
+            nodeState.pendingIncomingSigShares.Add(s.GetKey(), s);
+        }
+    }
+
+    if (dropped != 0) {
+        LogPrint("llmq-sigs", "CSigSharesManager::%s -- too many pending sig shares, dropped %d. node=%d\n", __func__,
+                 dropped, pfrom->id);
+        LOCK(statsCs);
+        droppedSigShares += dropped;
     }
     return true;
 }
@@ -582,12 +633,21 @@ bool CSigSharesManager::ProcessPendingSigShares(CConnman& connman)
 
     // It's ok to perform insecure batched verification here as we verify against the quorum public key shares,
     // which are not craftable by individual entities, making the rogue public key attack impossible
-    CBLSBatchVerifier<NodeId, SigShareKey> batchVerifier(false, true);
+    // The shares are split by node into independent batches which are verified in parallel on the worker pool. This
+    // also limits the impact of a node sending invalid shares to the batch it is part of
+    size_t batchCount = std::max((size_t)1, std::min(sigSharesByNodes.size(), (size_t)workerPool.size()));
+    std::vector<CBLSBatchVerifier<NodeId, SigShareKey>> batchVerifiers;
+    batchVerifiers.reserve(batchCount);
+    for (size_t i = 0; i < batchCount; i++) {
+        batchVerifiers.emplace_back(false, true);
+    }
 
     size_t verifyCount = 0;
+    size_t nodeIndex = 0;
     for (auto& p : sigSharesByNodes) {
         auto nodeId = p.first;
         auto& v = p.second;
+        auto& batchVerifier = batchVerifiers[(nodeIndex++) % batchCount];
 
         for (auto& sigShare : v) {
             if (quorumSigningManager->HasRecoveredSigForId((Consensus::LLMQType)sigShare.llmqType, sigShare.id)) {
@@ -618,16 +678,33 @@ bool CSigSharesManager::ProcessPendingSigShares(CConnman& connman)
     }
 
     cxxtimer::Timer verifyTimer(true);
-    batchVerifier.Verify();
+    std::vector<std::future<void>> verifyFutures;
+    for (size_t i = 1; i < batchCount; i++) {
+        auto& batchVerifier = batchVerifiers[i];
+        verifyFutures.emplace_back(workerPool.push([&batchVerifier](int) {
+            batchVerifier.Verify();
+        }));
+    }
+    batchVerifiers[0].Verify();
+    for (auto& f : verifyFutures) {
+        f.get();
+    }
     verifyTimer.stop();
 
-    LogPrint("llmq-sigs", "CSigSharesManager::%s -- verified sig shares. count=%d, vt=%d, nodes=%d\n", __func__, verifyCount, verifyTimer.count(), sigSharesByNodes.size());
+    std::set<NodeId> badSources;
+    for (auto& batchVerifier : batchVerifiers) {
+        badSources.insert(batchVerifier.badSources.begin(), batchVerifier.badSources.end());
+    }
+
+    LogPrint("llmq-sigs", "CSigSharesManager::%s -- verified sig shares. count=%d, vt=%d, nodes=%d, batches=%d\n", __func__, verifyCount, verifyTimer.count(), sigSharesByNodes.size(), batchCount);
 
+    cxxtimer::Timer processTimer(true);
+    std::unordered_map<uint256, std::tuple<CQuorumCPtr, uint256, uint256>, StaticSaltedHasher> sessionsToRecover;
     for (auto& p : sigSharesByNodes) {
         auto nodeId = p.first;
         auto& v = p.second;
 
-        if (batchVerifier.badSources.count(nodeId)) {
+        if (badSources.count(nodeId)) {
             LogPrintf("CSigSharesManager::%s -- invalid sig shares from other node, banning peer=%d\n",
                      __func__, nodeId);
             // this will also cause re-requesting of the shares that were sent by this node
@@ -635,8 +712,18 @@ bool CSigSharesManager::ProcessPendingSigShares(CConnman& connman)
             continue;
         }
 
-        ProcessPendingSigSharesFromNode(nodeId, v, quorums, connman);
+        ProcessPendingSigSharesFromNode(nodeId, v, quorums, sessionsToRecover, connman);
     }
+    processTimer.stop();
+
+    {
+        LOCK(statsCs);
+        verifyLatency.Add(verifyTimer.count());
+        processLatency.Add(processTimer.count());
+        lastRecoveryQueueSize = sessionsToRecover.size();
+    }
+
+    RecoverSigs(sessionsToRecover, connman);
 
     return true;
 }
@@ -645,14 +732,16 @@ bool CSigSharesManager::ProcessPendingSigShares(CConnman& connman)
 void CSigSharesManager::ProcessPendingSigSharesFromNode(NodeId nodeId,
         const std::vector<CSigShare>& sigShares,
         const std::unordered_map<std::pair<Consensus::LLMQType, uint256>, CQuorumCPtr, StaticSaltedHasher>& quorums,
+        std::unordered_map<uint256, std::tuple<CQuorumCPtr, uint256, uint256>, StaticSaltedHasher>& retSessionsToRecover,
         CConnman& connman)
 {
-    auto& nodeState = nodeStates[nodeId];
-
     cxxtimer::Timer t(true);
     for (auto& sigShare : sigShares) {
         auto quorumKey = std::make_pair((Consensus::LLMQType)sigShare.llmqType, sigShare.quorumHash);
-        ProcessSigShare(nodeId, sigShare, connman, quorums.at(quorumKey));
+        const auto& quorum = quorums.at(quorumKey);
+        if (ProcessSigShare(nodeId, sigShare, connman, quorum)) {
+            retSessionsToRecover.emplace(sigShare.GetSignHash(), std::make_tuple(quorum, sigShare.id, sigShare.msgHash));
+        }
     }
     t.stop();
 
@@ -661,7 +750,7 @@ void CSigSharesManager::ProcessPendingSigSharesFromNode(NodeId nodeId,
 }
 
 // sig shares are already verified when entering this method
-void CSigSharesManager::ProcessSigShare(NodeId nodeId, const CSigShare& sigShare, CConnman& connman, const CQuorumCPtr& quorum)
+bool CSigSharesManager::ProcessSigShare(NodeId nodeId, const CSigShare& sigShare, CConnman& connman, const CQuorumCPtr& quorum)
 {
     auto llmqType = quorum->params.type;
 
@@ -674,14 +763,14 @@ void CSigSharesManager::ProcessSigShare(NodeId nodeId, const CSigShare& sigShare
     }
 
     if (quorumSigningManager->HasRecoveredSigForId(llmqType, sigShare.id)) {
-        return;
+        return false;
     }
 
     {
         LOCK(cs);
 
         if (!sigShares.Add(sigShare.GetKey(), sigShare)) {
-            return;
+            return false;
         }
         sigSharesToAnnounce.Add(sigShare.GetKey(), true);
 
@@ -706,17 +795,68 @@ void CSigSharesManager::ProcessSigShare(NodeId nodeId, const CSigShare& sigShare
         }
     }
 
-    if (canTryRecovery) {
-        TryRecoverSig(quorum, sigShare.id, sigShare.msgHash, connman);
-    }
+    return canTryRecovery;
 }
 
 void CSigSharesManager::TryRecoverSig(const CQuorumCPtr& quorum, const uint256& id, const uint256& msgHash, CConnman& connman)
 {
-    if (quorumSigningManager->HasRecoveredSigForId(quorum->params.type, id)) {
+    CRecoveredSig rs;
+    if (RecoverSig(quorum, id, msgHash, rs)) {
+        quorumSigningManager->ProcessRecoveredSig(-1, rs, quorum, connman);
+    }
+}
+
+// Sessions are independent of each other, so their signatures are recovered in parallel on the worker pool. The
+// recovered sigs are then passed to the signing manager from the calling thread
+void CSigSharesManager::RecoverSigs(const std::unordered_map<uint256, std::tuple<CQuorumCPtr, uint256, uint256>, StaticSaltedHasher>& sessionsToRecover, CConnman& connman)
+{
+    if (sessionsToRecover.empty()) {
         return;
     }
 
+    cxxtimer::Timer t(true);
+
+    std::vector<std::pair<CQuorumCPtr, CRecoveredSig>> recovered(sessionsToRecover.size());
+    std::vector<std::future<bool>> futures;
+    futures.reserve(sessionsToRecover.size());
+
+    size_t i = 0;
+    for (const auto& p : sessionsToRecover) {
+        const auto& quorum = std::get<0>(p.second);
+        const auto& id = std::get<1>(p.second);
+        const auto& msgHash = std::get<2>(p.second);
+        auto& ret = recovered[i++];
+        ret.first = quorum;
+        if (workerPool.size() == 0) {
+            std::promise<bool> promise;
+            promise.set_value(RecoverSig(quorum, id, msgHash, ret.second));
+            futures.emplace_back(promise.get_future());
+        } else {
+            futures.emplace_back(workerPool.push([this, quorum, id, msgHash, &ret](int) {
+                return RecoverSig(quorum, id, msgHash, ret.second);
+            }));
+        }
+    }
+
+    for (size_t j = 0; j < futures.size(); j++) {
+        if (futures[j].get()) {
+            quorumSigningManager->ProcessRecoveredSig(-1, recovered[j].second, recovered[j].first, connman);
+        }
+    }
+
+    t.stop();
+    LogPrint("llmq-sigs", "CSigSharesManager::%s -- recovered sessions. count=%d, time=%d\n", __func__, sessionsToRecover.size(), t.count());
+
+    LOCK(statsCs);
+    recoverLatency.Add(t.count());
+}
+
+bool CSigSharesManager::RecoverSig(const CQuorumCPtr& quorum, const uint256& id, const uint256& msgHash, CRecoveredSig& retRecSig)
+{
+    if (quorumSigningManager->HasRecoveredSigForId(quorum->params.type, id)) {
+        return false;
+    }
+
     std::vector<CBLSSignature> sigSharesForRecovery;
     std::vector<CBLSId> idsForRecovery;
     {
@@ -727,7 +867,7 @@ void CSigSharesManager::TryRecoverSig(const CQuorumCPtr& quorum, const uint256&
         auto signHash = CLLMQUtils::BuildSignHash(quorum->params.type, quorum->qc.quorumHash, id, msgHash);
         auto sigShares = this->sigShares.GetAllForSignHash(signHash);
         if (!sigShares) {
-            return;
+            return false;
         }
 
         sigSharesForRecovery.reserve((size_t) quorum->params.threshold);
@@ -740,7 +880,7 @@ void CSigSharesManager::TryRecoverSig(const CQuorumCPtr& quorum, const uint256&
 
         // check if we can recover the final signature
         if (sigSharesForRecovery.size() < quorum->params.threshold) {
-            return;
+            return false;
         }
     }
 
@@ -750,13 +890,13 @@ void CSigSharesManager::TryRecoverSig(const CQuorumCPtr& quorum, const uint256&
     if (!recoveredSig.Recover(sigSharesForRecovery, idsForRecovery)) {
         LogPrintf("CSigSharesManager::%s -- failed to recover signature. id=%s, msgHash=%s, time=%d\n", __func__,
                   id.ToString(), msgHash.ToString(), t.count());
-        return;
+        return false;
     }
 
     LogPrint("llmq-sigs", "CSigSharesManager::%s -- recovered signature. id=%s, msgHash=%s, time=%d\n", __func__,
               id.ToString(), msgHash.ToString(), t.count());
 
-    CRecoveredSig rs;
+    CRecoveredSig& rs = retRecSig;
     rs.llmqType = quorum->params.type;
     rs.quorumHash = quorum->qc.quorumHash;
     rs.id = id;
@@ -774,11 +914,11 @@ void CSigSharesManager::TryRecoverSig(const CQuorumCPtr& quorum, const uint256&
             // this should really not happen as we have verified all signature shares before
             LogPrintf("CSigSharesManager::%s -- own recovered signature is invalid. id=%s, msgHash=%s\n", __func__,
                       id.ToString(), msgHash.ToString());
-            return;
+            return false;
         }
     }
 
-    quorumSigningManager->ProcessRecoveredSig(-1, rs, quorum, connman);
+    return true;
 }
 
 void CSigSharesManager::CollectSigSharesToRequest(std::unordered_map<NodeId, std::unordered_map<uint256, CSigSharesInv, StaticSaltedHasher>>& sigSharesToRequest)
@@ -1431,7 +1571,9 @@ void CSigSharesManager::Sign(const CQuorumCPtr& quorum, const uint256& id, const
 
     LogPrint("llmq-sigs", "CSigSharesManager::%s -- signed sigShare. signHash=%s, id=%s, msgHash=%s, llmqType=%d, quorum=%s, time=%s\n", __func__,
               signHash.ToString(), sigShare.id.ToString(), sigShare.msgHash.ToString(), quorum->params.type, quorum->qc.quorumHash.ToString(), t.count());
-    ProcessSigShare(-1, sigShare, *g_connman, quorum);
+    if (ProcessSigShare(-1, sigShare, *g_connman, quorum)) {
+        TryRecoverSig(quorum, sigShare.id, sigShare.msgHash, *g_connman);
+    }
 }
 
 // causes all known sigShares to be re-announced
@@ -1465,4 +1607,40 @@ void CSigSharesManager::HandleNewRecoveredSig(const llmq::CRecoveredSig& recover
     RemoveSigSharesForSession(CLLMQUtils::BuildSignHash(recoveredSig));
 }
 
+UniValue CSigSharesManager::GetStats()
+{
+    size_t pendingSigShares = 0;
+    size_t pendingNodes = 0;
+    size_t sigShareCount;
+    {
+        LOCK(cs);
+        for (auto& p : nodeStates) {
+            size_t n = p.second.pendingIncomingSigShares.Size();
+            pendingSigShares += n;
+            pendingNodes += n != 0;
+        }
+        sigShareCount = sigShares.Size();
+    }
+
+    UniValue ret(UniValue::VOBJ);
+
+    UniValue queues(UniValue::VOBJ);
+    queues.push_back(Pair("pendingVerification", (int64_t)pendingSigShares));
+    queues.push_back(Pair("pendingVerificationNodes", (int64_t)pendingNodes));
+    queues.push_back(Pair("sigShares", (int64_t)sigShareCount));
+
+    LOCK(statsCs);
+    queues.push_back(Pair("lastRecovery", (int64_t)lastRecoveryQueueSize));
+    ret.push_back(Pair("queues", queues));
+    ret.push_back(Pair("droppedSigShares", droppedSigShares));
+    ret.push_back(Pair("workerThreads", workerPool.size()));
+
+    UniValue latencies(UniValue::VOBJ);
+    latencies.push_back(Pair("verify", verifyLatency.ToJson()));
+    latencies.push_back(Pair("process", processLatency.ToJson()));
+    latencies.push_back(Pair("recover", recoverLatency.ToJson()));
+    ret.push_back(Pair("latencies", latencies));
+    return ret;
+}
+
 }
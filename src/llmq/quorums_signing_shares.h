@@ -7,6 +7,7 @@
 
 #include "bls/bls.h"
 #include "chainparams.h"
+#include "ctpl.h"
 #include "net.h"
 #include "random.h"
 #include "saltedhasher.h"
@@ -14,9 +15,11 @@
 #include "sync.h"
 #include "tinyformat.h"
 #include "uint256.h"
+#include "univalue.h"
 
 #include "llmq/quorums.h"
 
+#include <array>
 #include <thread>
 #include <mutex>
 #include <unordered_map>
@@ -328,6 +331,22 @@ public:
     void RemoveSession(const uint256& signHash);
 };
 
+// Latencies of one stage of the sig share processing, bucket i counts durations below 2^i milliseconds and the last
+// bucket everything slower
+class CSigSharesLatencyHistogram
+{
+public:
+    static const size_t BUCKET_COUNT = 12;
+
+    std::array<uint64_t, BUCKET_COUNT> buckets{};
+    uint64_t count{0};
+    uint64_t totalMs{0};
+
+public:
+    void Add(int64_t ms);
+    UniValue ToJson() const;
+};
+
 class CSigSharesManager : public CRecoveredSigsListener
 {
     static const int64_t SESSION_NEW_SHARES_TIMEOUT = 60;
@@ -339,6 +358,9 @@ class CSigSharesManager : public CRecoveredSigsListener
     const size_t MAX_MSGS_CNT_QSIGSHARESINV = 200;
     // 400 is the maximum quorum size, so this is also the maximum number of sigs we need to support
     const size_t MAX_MSGS_TOTAL_BATCHED_SIGS = 400;
+    // incoming shares of a node waiting for verification. Shares above this are dropped instead of queued, they are
+    // requested again from other nodes once the request times out
+    const size_t MAX_PENDING_SIG_SHARES_PER_NODE = 4 * MAX_MSGS_TOTAL_BATCHED_SIGS;
 
 private:
     CCriticalSection cs;
@@ -346,6 +368,16 @@ private:
     std::thread workThread;
     CThreadInterrupt workInterrupt;
 
+    // verifies sig share batches and recovers signatures for the work thread
+    ctpl::thread_pool workerPool;
+
+    CCriticalSection statsCs;
+    CSigSharesLatencyHistogram verifyLatency;
+    CSigSharesLatencyHistogram processLatency;
+    CSigSharesLatencyHistogram recoverLatency;
+    uint64_t droppedSigShares{0};
+    size_t lastRecoveryQueueSize{0};
+
     SigShareMap<CSigShare> sigShares;
 
     // stores time of last receivedSigShare. Used to detect timeouts
@@ -382,6 +414,8 @@ public:
 
     void HandleNewRecoveredSig(const CRecoveredSig& recoveredSig);
 
+    UniValue GetStats();
+
 private:
     // all of these return false when the currently processed message should be aborted (as each message actually contains multiple messages)
     bool ProcessMessageSigSesAnn(CNode* pfrom, const CSigSesAnn& ann, CConnman& connman);
@@ -400,10 +434,14 @@ private:
     void ProcessPendingSigSharesFromNode(NodeId nodeId,
             const std::vector<CSigShare>& sigShares,
             const std::unordered_map<std::pair<Consensus::LLMQType, uint256>, CQuorumCPtr, StaticSaltedHasher>& quorums,
+            std::unordered_map<uint256, std::tuple<CQuorumCPtr, uint256, uint256>, StaticSaltedHasher>& retSessionsToRecover,
             CConnman& connman);
 
-    void ProcessSigShare(NodeId nodeId, const CSigShare& sigShare, CConnman& connman, const CQuorumCPtr& quorum);
+    // returns true when the session of the share has enough shares to try recovery
+    bool ProcessSigShare(NodeId nodeId, const CSigShare& sigShare, CConnman& connman, const CQuorumCPtr& quorum);
     void TryRecoverSig(const CQuorumCPtr& quorum, const uint256& id, const uint256& msgHash, CConnman& connman);
+    bool RecoverSig(const CQuorumCPtr& quorum, const uint256& id, const uint256& msgHash, CRecoveredSig& retRecSig);
+    void RecoverSigs(const std::unordered_map<uint256, std::tuple<CQuorumCPtr, uint256, uint256>, StaticSaltedHasher>& sessionsToRecover, CConnman& connman);
 
 private:
     bool GetSessionInfoByRecvId(NodeId nodeId, uint32_t sessionId, CSigSharesNodeState::SessionInfo& retInfo);
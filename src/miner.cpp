@@ -951,12 +951,15 @@ static bool ProcessBlockFound(const CBlock* pblock, const CChainParams& chainpar
     return true;
 }
 
-void static TecraCoinMiner(const CChainParams &chainparams) {
+void static TecraCoinMiner(const CChainParams &chainparams, int nMTPThreads) {
     SetThreadPriority(THREAD_PRIORITY_LOWEST);
     RenameThread("tecracoin-miner");
 
     unsigned int nExtraNonce = 0;
 
+    // Argon2 matrix of the MTP hash, reused for every block template this miner works on
+    mtp::MemoryArena mtpArena;
+
     boost::shared_ptr<CReserveScript> coinbaseScript;
     GetMainSignals().ScriptForMining(coinbaseScript);
     bool fTestNet = chainparams.GetConsensus().IsTestnet();
@@ -1038,7 +1041,7 @@ void static TecraCoinMiner(const CChainParams &chainparams) {
                     if (pblock->IsMTP()) {
                         //sleep(60);
                         LogPrintf("BEFORE: mtp_hash\n");
-                        thash = mtp::hash(*pblock, Params().GetConsensus().powLimit);
+                        thash = mtp::hash(*pblock, Params().GetConsensus().powLimit, &mtpArena, nMTPThreads);
                         pblock->mtpHashValue = thash;
                     } else {
                         lyra2z_hash(BEGIN(pblock->nVersion), BEGIN(thash));
@@ -1116,8 +1119,15 @@ void GenerateBitcoins(bool fGenerate, int nThreads, const CChainParams& chainpar
         return;
 
     minerThreads = new boost::thread_group();
-    for (int i = 0; i < nThreads; i++)
-        minerThreads->create_thread(boost::bind(&TecraCoinMiner, boost::cref(chainparams)));
+    if (GetAdjustedTime() >= chainparams.GetConsensus().nMTPSwitchTime) {
+        // Every MTP block template needs several GiB of memory, so rather than one template
+        // per thread run a single miner and spread its nonce search over all the threads
+        minerThreads->create_thread(boost::bind(&TecraCoinMiner, boost::cref(chainparams), nThreads));
+    }
+    else {
+        for (int i = 0; i < nThreads; i++)
+            minerThreads->create_thread(boost::bind(&TecraCoinMiner, boost::cref(chainparams), 1));
+    }
 }
 
 void IncrementExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned int& nExtraNonce)
@@ -2755,6 +2755,12 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
             return true;
         }
 
+        // Hash the whole batch and check its proof of work in parallel before taking cs_main.
+        // The in-order linkage checks below then hit the per-header hash memo. A failing header
+        // is rejected with the usual DoS score by ProcessNewBlockHeaders.
+        if (!CheckBlockHeadersProofOfWork(headers, chainparams.GetConsensus()))
+            LogPrint("net", "headers from peer=%d failed proof of work batch check\n", pfrom->id);
+
         const CBlockIndex *pindexLast = NULL;
         {
         LOCK(cs_main);
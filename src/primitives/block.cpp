@@ -16,6 +16,8 @@
 #include "crypto/Lyra2Z/Lyra2.h"
 #include "crypto/MerkleTreeProof/mtp.h"
 #include "util.h"
+#include "sync.h"
+#include "unordered_lru_cache.h"
 #include <iostream>
 #include <chrono>
 #include <fstream>
@@ -44,12 +46,47 @@ unsigned char GetNfactor(int64_t nTimestamp) {
     return std::min(std::max(N, Params().GetConsensus().nMinNFactor), Params().GetConsensus().nMaxNFactor);
 }
 
+namespace {
+
+/** Keys are SHA256d digests of the header bytes and are already uniformly distributed */
+struct HeaderHashCacheHasher
+{
+    size_t operator()(const uint256& key) const { return key.GetCheapHash(); }
+};
+
+/** Process-wide Lyra2Z memo for headers which arrive more than once as separate objects
+ * (announced by several peers, as a compact block and then as a full block, etc.) */
+CCriticalSection cs_headerHashCache;
+unordered_lru_cache<uint256, uint256, HeaderHashCacheHasher, 20000> headerHashCache;
+
+}
+
 uint256 CBlockHeader::GetHash() const {
+    if (!cachedHash.IsNull() && memcmp(cachedHashInput, BEGIN(nVersion), HASH_INPUT_SIZE) == 0)
+        return cachedHash;
+
+    uint256 cacheKey = Hash(BEGIN(nVersion), BEGIN(nVersion) + HASH_INPUT_SIZE);
     uint256 thash;
-    lyra2z_hash(BEGIN(nVersion), BEGIN(thash));
+    bool fCached;
+    {
+        LOCK(cs_headerHashCache);
+        fCached = headerHashCache.get(cacheKey, thash);
+    }
+    if (!fCached) {
+        lyra2z_hash(BEGIN(nVersion), BEGIN(thash));
+        LOCK(cs_headerHashCache);
+        headerHashCache.insert(cacheKey, thash);
+    }
+
+    SetCachedHash(thash);
     return thash;
 }
 
+void CBlockHeader::SetCachedHash(const uint256& hash) const {
+    memcpy(cachedHashInput, BEGIN(nVersion), HASH_INPUT_SIZE);
+    cachedHash = hash;
+}
+
 bool CBlockHeader::IsMTP() const {
     // In case if nTime == ZC_GENESIS_BLOCK_TIME we're being called from CChainParams() constructor and
     // it is not possible to get Params()
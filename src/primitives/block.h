@@ -42,7 +42,7 @@ class CMTPHashData {
 public:
     uint8_t hashRootMTP[16]; // 16 is 128 bit of blake2b
     uint64_t nBlockMTP[mtp::MTP_L*2][128]; // 128 is ARGON2_QWORDS_IN_BLOCK
-    std::deque<std::vector<uint8_t>> nProofMTP[mtp::MTP_L*3];
+    mtp::ProofSet nProofMTP; // MTP_L*3 proofs in a single buffer
 
     CMTPHashData() {
         memset(nBlockMTP, 0, sizeof(nBlockMTP));
@@ -59,15 +59,12 @@ public:
     inline void SerializationOp(Stream &s, Operation ser_action) {
         READWRITE(hashRootMTP);
         READWRITE(nBlockMTP);
-        for (int i = 0; i < mtp::MTP_L*3; i++) {
-            assert(nProofMTP[i].size() < 256);
-            uint8_t numberOfProofBlocks = (uint8_t)nProofMTP[i].size();
+        for (size_t i = 0; i < mtp::ProofSet::PROOF_COUNT; i++) {
+            size_t proofSize = nProofMTP.GetProofSize(i);
+            assert(proofSize < 256);
+            uint8_t numberOfProofBlocks = (uint8_t)proofSize;
             READWRITE(numberOfProofBlocks);
-            for (const std::vector<uint8_t> &mtpData: nProofMTP[i]) {
-                // data size should be 16 for each block
-                assert(mtpData.size() == 16);
-                s.write((const char *)mtpData.data(), 16);
-            }
+            s.write((const char *)nProofMTP.GetProof(i), proofSize * mtp::ProofSet::NODE_SIZE);
         }
     }
 
@@ -76,14 +73,12 @@ public:
     inline void SerializationOp(Stream &s, CSerActionUnserialize ser_action) {
         READWRITE(hashRootMTP);
         READWRITE(nBlockMTP);
-        for (int i = 0; i < mtp::MTP_L*3; i++) {
+        nProofMTP.Clear();
+        for (size_t i = 0; i < mtp::ProofSet::PROOF_COUNT; i++) {
             uint8_t numberOfProofBlocks;
             READWRITE(numberOfProofBlocks);
-            for (uint8_t j=0; j<numberOfProofBlocks; j++) {
-                vector<uint8_t> mtpData(16, 0);
-                s.read((char *)mtpData.data(), 16);
-                nProofMTP[i].emplace_back(std::move(mtpData));
-            }
+            uint8_t *nodes = nProofMTP.AppendProof(numberOfProofBlocks);
+            s.read((char *)nodes, numberOfProofBlocks * mtp::ProofSet::NODE_SIZE);
         }
     }
 };
@@ -113,6 +108,14 @@ public:
 
     mutable uint256 cachedPoWHash;
 
+    //! Size of the header prefix hashed by GetHash() (nVersion..nNonce)
+    static const size_t HASH_INPUT_SIZE = 80;
+
+    //! Lyra2Z hash memo together with the header bytes it was computed from, so that
+    //! modifying any header field (e.g. nNonce while mining) invalidates it implicitly
+    mutable uint256 cachedHash;
+    mutable unsigned char cachedHashInput[HASH_INPUT_SIZE];
+
     CBlockHeader()
     {
         SetNull();
@@ -175,6 +178,7 @@ public:
         nBits = 0;
         nNonce = 0;
         cachedPoWHash.SetNull();
+        cachedHash.SetNull();
 
         // TecraCoin - MTP
         mtpHashData.reset();
@@ -197,6 +201,9 @@ public:
 
     uint256 GetHash() const;
 
+    /** Seed the GetHash() memo with an already known hash of this header (e.g. the block index key) */
+    void SetCachedHash(const uint256& hash) const;
+
     int64_t GetBlockTime() const
     {
         return (int64_t)nTime;
@@ -236,6 +236,39 @@ private:
 };
 
 
+// Accumulator witness of a wallet mint, kept so spends only add the coins minted since it was computed
+class CZerocoinWitnessEntry
+{
+public:
+    int denomination;
+    int id;
+    // witness value for the coins of the group minted up to blockHash
+    Bignum witnessValue;
+    uint256 blockHash;
+
+    CZerocoinWitnessEntry()
+    {
+        SetNull();
+    }
+
+    void SetNull()
+    {
+        denomination = 0;
+        id = 0;
+        witnessValue = 0;
+        blockHash.SetNull();
+    }
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(denomination);
+        READWRITE(id);
+        READWRITE(witnessValue);
+        READWRITE(blockHash);
+    }
+};
+
 class CZerocoinSpendEntry
 {
 public:
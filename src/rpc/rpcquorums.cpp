@@ -11,6 +11,7 @@
 #include "llmq/quorums_debug.h"
 #include "llmq/quorums_dkgsession.h"
 #include "llmq/quorums_signing.h"
+#include "llmq/quorums_signing_shares.h"
 
 void quorum_list_help()
 {
@@ -340,6 +341,54 @@ UniValue quorum_sigs_cmd(const JSONRPCRequest& request)
     }
 }
 
+void quorum_sigcachestats_help()
+{
+    throw std::runtime_error(
+            "quorum sigcachestats\n"
+            "Return hit and miss counters of the recovered signature caches.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"id\": { \"hits\": n, \"misses\": n },        (object) Lookups by request id (hasrecsig, isconflicting)\n"
+            "  \"session\": { \"hits\": n, \"misses\": n },   (object) Lookups by signing session\n"
+            "  \"hash\": { \"hits\": n, \"misses\": n }       (object) Lookups by recovered signature hash (inventory)\n"
+            "}\n"
+    );
+}
+
+UniValue quorum_sigcachestats(const JSONRPCRequest& request)
+{
+    if (request.fHelp || (request.params.size() != 1)) {
+        quorum_sigcachestats_help();
+    }
+
+    return llmq::quorumSigningManager->GetCacheStats();
+}
+
+void quorum_sigsharestats_help()
+{
+    throw std::runtime_error(
+            "quorum sigsharestats\n"
+            "Return queue depths and per stage latencies of the signature share processing.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"queues\": {...},             (object) Shares waiting for verification, known shares and sessions\n"
+            "                                 handed to the last recovery round\n"
+            "  \"droppedSigShares\": n,       (numeric) Shares dropped because a node had too many pending shares\n"
+            "  \"workerThreads\": n,          (numeric) Threads verifying batches and recovering signatures\n"
+            "  \"latencies\": {...}           (object) Histograms of the verify, process and recover stages\n"
+            "}\n"
+    );
+}
+
+UniValue quorum_sigsharestats(const JSONRPCRequest& request)
+{
+    if (request.fHelp || (request.params.size() != 1)) {
+        quorum_sigsharestats_help();
+    }
+
+    return llmq::quorumSigSharesManager->GetStats();
+}
+
 void quorum_dkgsimerror_help()
 {
     throw std::runtime_error(
@@ -390,6 +439,8 @@ UniValue quorum_dkgsimerror(const JSONRPCRequest& request)
             "  hasrecsig         - Test if a valid recovered signature is present\n"
             "  getrecsig         - Get a recovered signature\n"
             "  isconflicting     - Test if a conflict exists\n"
+            "  sigcachestats     - Return recovered signature cache statistics\n"
+            "  sigsharestats     - Return signature share processing statistics\n"
     );
 }
 
@@ -414,6 +465,10 @@ UniValue quorum(const JSONRPCRequest& request)
         return quorum_memberof(request);
     } else if (command == "sign" || command == "hasrecsig" || command == "getrecsig" || command == "isconflicting") {
         return quorum_sigs_cmd(request);
+    } else if (command == "sigcachestats") {
+        return quorum_sigcachestats(request);
+    } else if (command == "sigsharestats") {
+        return quorum_sigsharestats(request);
     } else if (command == "dkgsimerror") {
         return quorum_dkgsimerror(request);
     } else {
@@ -101,6 +101,7 @@ public:
   GroupElement& set_base_g();
 
   friend class MultiExponent;
+  friend class PrecomputedMultiExponent;
 private:
     // Returns the secp object inside it.
     const void * get_value() const;
@@ -0,0 +1,39 @@
+#ifndef SECP_PRECOMPUTED_MULTIEXPONENT_H
+#define SECP_PRECOMPUTED_MULTIEXPONENT_H
+
+#include <vector>
+#include "../include/GroupElement.h"
+#include "../include/Scalar.h"
+
+namespace secp_primitives {
+
+// Multi-exponentiation over a fixed list of generators. For every generator the multiples
+// d * 16^w * G for all 4 bit digits d and windows w are computed once in the constructor,
+// a multiplication is then a table lookup and an addition per non-zero digit, no doublings.
+// Lookups depend on the scalars, use it with public values only.
+class PrecomputedMultiExponent {
+public:
+    explicit PrecomputedMultiExponent(const std::vector<GroupElement>& generators);
+    ~PrecomputedMultiExponent();
+
+    PrecomputedMultiExponent(const PrecomputedMultiExponent&) = delete;
+    PrecomputedMultiExponent& operator=(const PrecomputedMultiExponent&) = delete;
+
+    // Sum of powers[i] * generators[offset + i]
+    GroupElement get_multiple(const std::vector<Scalar>& powers, std::size_t offset = 0) const;
+
+    // power * generators[index]
+    GroupElement get_multiple(std::size_t index, const Scalar& power) const;
+
+    std::size_t size() const { return n_points; }
+
+private:
+    void add_multiple(void *result, std::size_t index, const Scalar& power) const;
+
+    void *table_; // secp256k1_ge[]
+    std::size_t n_points;
+};
+
+}// namespace secp_primitives
+
+#endif //SECP_PRECOMPUTED_MULTIEXPONENT_H
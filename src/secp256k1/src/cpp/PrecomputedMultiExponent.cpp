@@ -0,0 +1,89 @@
+#include "../include/PrecomputedMultiExponent.h"
+
+#include "../include/secp256k1.h"
+#include "../field.h"
+#include "../field_impl.h"
+#include "../group.h"
+#include "../group_impl.h"
+#include "../scalar.h"
+#include "../scalar_impl.h"
+
+#include <new>
+#include <stdexcept>
+
+namespace {
+
+const int WINDOW_BITS = 4;
+// non-zero digits of a window
+const int WINDOW_SIZE = (1 << WINDOW_BITS) - 1;
+const int WINDOWS = 256 / WINDOW_BITS;
+const std::size_t TABLE_SIZE = WINDOWS * WINDOW_SIZE;
+
+void out_of_memory(const char *, void *) {
+    throw std::bad_alloc();
+}
+
+const secp256k1_callback out_of_memory_callback = { out_of_memory, NULL };
+
+} // namespace
+
+namespace secp_primitives {
+
+PrecomputedMultiExponent::PrecomputedMultiExponent(const std::vector<GroupElement>& generators)
+        : table_(new secp256k1_ge[generators.size() * TABLE_SIZE])
+        , n_points(generators.size())
+{
+    secp256k1_ge *table = reinterpret_cast<secp256k1_ge *>(table_);
+    std::vector<secp256k1_gej> multiples(TABLE_SIZE);
+    for (std::size_t i = 0; i < n_points; ++i) {
+        if (generators[i].isInfinity())
+            throw std::invalid_argument("PrecomputedMultiExponent: generator is the point at infinity");
+
+        // base is 16^w * G for the current window w
+        secp256k1_gej base = *reinterpret_cast<const secp256k1_gej *>(generators[i].get_value());
+        for (int w = 0; w < WINDOWS; ++w) {
+            secp256k1_gej *window = &multiples[w * WINDOW_SIZE];
+            window[0] = base;
+            for (int d = 1; d < WINDOW_SIZE; ++d)
+                secp256k1_gej_add_var(&window[d], &window[d - 1], &base, NULL);
+            for (int b = 0; b < WINDOW_BITS; ++b)
+                secp256k1_gej_double_var(&base, &base, NULL);
+        }
+        secp256k1_ge_set_all_gej_var(&table[i * TABLE_SIZE], multiples.data(), TABLE_SIZE, &out_of_memory_callback);
+    }
+}
+
+PrecomputedMultiExponent::~PrecomputedMultiExponent() {
+    delete []reinterpret_cast<secp256k1_ge *>(table_);
+}
+
+void PrecomputedMultiExponent::add_multiple(void *result, std::size_t index, const Scalar& power) const {
+    if (index >= n_points)
+        throw std::out_of_range("PrecomputedMultiExponent: no such generator");
+
+    secp256k1_gej *r = reinterpret_cast<secp256k1_gej *>(result);
+    const secp256k1_ge *window = reinterpret_cast<const secp256k1_ge *>(table_) + index * TABLE_SIZE;
+    const secp256k1_scalar *s = reinterpret_cast<const secp256k1_scalar *>(power.get_value());
+    for (int w = 0; w < WINDOWS; ++w, window += WINDOW_SIZE) {
+        unsigned int digit = secp256k1_scalar_get_bits(s, w * WINDOW_BITS, WINDOW_BITS);
+        if (digit)
+            secp256k1_gej_add_ge_var(r, r, &window[digit - 1], NULL);
+    }
+}
+
+GroupElement PrecomputedMultiExponent::get_multiple(const std::vector<Scalar>& powers, std::size_t offset) const {
+    secp256k1_gej r;
+    secp256k1_gej_set_infinity(&r);
+    for (std::size_t i = 0; i < powers.size(); ++i)
+        add_multiple(&r, offset + i, powers[i]);
+    return &r;
+}
+
+GroupElement PrecomputedMultiExponent::get_multiple(std::size_t index, const Scalar& power) const {
+    secp256k1_gej r;
+    secp256k1_gej_set_infinity(&r);
+    add_multiple(&r, index, power);
+    return &r;
+}
+
+}// namespace secp_primitives
@@ -0,0 +1,85 @@
+// Copyright (c) 2020 The TecraCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef TECRACOIN_SHARDED_LRU_CACHE_H
+#define TECRACOIN_SHARDED_LRU_CACHE_H
+
+#include "sync.h"
+#include "unordered_lru_cache.h"
+
+#include <array>
+#include <atomic>
+
+/**
+ * A thread safe unordered_lru_cache split into independently locked shards.
+ *
+ * The shard is picked by the hash of the key, so lookups from different threads only contend when they hit the same
+ * shard. Each shard evicts on its own and keeps up to MaxSize entries. Hits and misses of get() are counted without
+ * taking any lock.
+ */
+template<typename Key, typename Value, typename Hasher, size_t MaxSize, size_t Shards = 16>
+class sharded_lru_cache
+{
+private:
+    struct Shard {
+        CCriticalSection cs;
+        unordered_lru_cache<Key, Value, Hasher, MaxSize> cache;
+    };
+
+    std::array<Shard, Shards> shards;
+    Hasher hasher;
+
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+
+public:
+    bool get(const Key& key, Value& value)
+    {
+        Shard& shard = get_shard(key);
+        bool found;
+        {
+            LOCK(shard.cs);
+            found = shard.cache.get(key, value);
+        }
+        if (found) {
+            hits.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            misses.fetch_add(1, std::memory_order_relaxed);
+        }
+        return found;
+    }
+
+    void insert(const Key& key, const Value& v)
+    {
+        Shard& shard = get_shard(key);
+        LOCK(shard.cs);
+        shard.cache.insert(key, v);
+    }
+
+    void erase(const Key& key)
+    {
+        Shard& shard = get_shard(key);
+        LOCK(shard.cs);
+        shard.cache.erase(key);
+    }
+
+    void clear()
+    {
+        for (auto& shard : shards) {
+            LOCK(shard.cs);
+            shard.cache.clear();
+        }
+    }
+
+    uint64_t hit_count() const { return hits.load(std::memory_order_relaxed); }
+    uint64_t miss_count() const { return misses.load(std::memory_order_relaxed); }
+
+private:
+    Shard& get_shard(const Key& key)
+    {
+        return shards[hasher(key) % Shards];
+    }
+};
+
+#endif // TECRACOIN_SHARDED_LRU_CACHE_H
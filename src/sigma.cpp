@@ -13,10 +13,12 @@
 #include "sigma/coinspend.h"
 #include "sigma/coin.h"
 #include "sigma/remint.h"
+#include "spendcache.h"
 #include "tnode-payments.h"
 #include "tnode-sync.h"
 #include "primitives/zerocoin.h"
 
+#include <algorithm>
 #include <atomic>
 #include <sstream>
 #include <chrono>
@@ -188,7 +190,8 @@ bool CheckSigmaSpendTransaction(
         int nRealHeight,
         bool isCheckWallet,
         bool fStatefulSigmaCheck,
-        CSigmaTxInfo *sigmaTxInfo) {
+        CSigmaTxInfo *sigmaTxInfo,
+        CSigmaSpendBatch *spendBatch) {
     bool hasSigmaSpendInputs = false, hasNonSigmaInputs = false;
     int vinIndex = -1;
     std::unordered_set<Scalar, sigma::CScalarHash> txSerials;
@@ -254,8 +257,6 @@ bool CheckSigmaSpendTransaction(
 
         bool passVerify = false;
         CBlockIndex *index = coinGroup.lastBlock;
-        pair<sigma::CoinDenomination, int> denominationAndId = std::make_pair(
-            targetDenominations[vinIndex], coinGroupId);
 
         uint256 accumulatorBlockHash = spend->getAccumulatorBlockHash();
 
@@ -269,20 +270,6 @@ bool CheckSigmaSpendTransaction(
         while (index != coinGroup.firstBlock && index->GetBlockHash() != accumulatorBlockHash)
             index = index->pprev;
 
-        // Build a vector with all the public coins with given denomination and accumulator id before
-        // the block on which the spend occured.
-        // This list of public coins is required by function "Verify" of CoinSpend.
-        std::vector<sigma::PublicCoin> anonymity_set;
-        while(true) {
-            BOOST_FOREACH(const sigma::PublicCoin& pubCoinValue,
-                    index->sigmaMintedPubCoins[denominationAndId]) {
-                anonymity_set.push_back(pubCoinValue);
-            }
-            if (index == coinGroup.firstBlock)
-                break;
-            index = index->pprev;
-        }
-
         bool fPadding = spend->getVersion() >= ZEROCOIN_TX_VERSION_3_1;
         if (!isVerifyDB) {
             bool fShouldPad = (nHeight != INT_MAX && nHeight >= params.nSigmaPaddingBlock) ||
@@ -291,7 +278,39 @@ bool CheckSigmaSpendTransaction(
                 return state.DoS(1, error("Incorrect sigma spend transaction version"));
         }
 
-        passVerify = spend->Verify(anonymity_set, newMetaData, fPadding);
+        // A spend accepted to the mempool was verified against the same coins, the ones of the
+        // group up to the block of index, it doesn't need to be verified again with its block
+        CHashWriter cacheHasher = SpendCacheHasher();
+        cacheHasher << *spend << newMetaData << (int)targetDenominations[vinIndex] << index->GetBlockHash() << fPadding;
+        uint256 cacheEntry = cacheHasher.GetHash();
+        bool fCached = IsSpendProofCached(cacheEntry);
+
+        // Build a vector with all the public coins with given denomination and accumulator id before
+        // the block on which the spend occured.
+        // This list of public coins is required by function "Verify" of CoinSpend.
+        // Spends of the same block over the same set share it in the batch.
+        CSigmaSpendBatch::AnonymitySetKey setKey(targetDenominations[vinIndex], coinGroupId, index);
+        if (fCached) {
+            passVerify = true;
+        } else {
+            std::vector<sigma::PublicCoin> localAnonymitySet;
+            std::vector<sigma::PublicCoin>& anonymity_set =
+                spendBatch ? spendBatch->GetAnonymitySet(setKey) : localAnonymitySet;
+            if (anonymity_set.empty()) {
+                uint256 setBlockHash;
+                sigmaState.GetCoinSetForSpend(&chainActive, index->nHeight,
+                    targetDenominations[vinIndex], coinGroupId, setBlockHash, anonymity_set);
+            }
+
+            // With a batch only the signature is checked now, the proof is verified with the whole block
+            if (spendBatch) {
+                passVerify = spend->VerifySignature(newMetaData);
+            } else {
+                passVerify = spend->Verify(anonymity_set, newMetaData, fPadding);
+                if (passVerify && nHeight == INT_MAX && !isVerifyDB)
+                    AddSpendProofToCache(cacheEntry);
+            }
+        }
         if (passVerify) {
             Scalar serial = spend->getCoinSerialNumber();
             // do not check for duplicates in case we've seen exact copy of this tx in this block before
@@ -316,6 +335,9 @@ bool CheckSigmaSpendTransaction(
                                 serial, CSpendCoinInfo::make(spend->getDenomination(), coinGroupId)));
                 }
             }
+
+            if (spendBatch && !fCached)
+                spendBatch->AddSpend(setKey, std::move(spend), fPadding);
         }
         else {
             LogPrintf("CheckSigmaSpendTransaction: verification failed at block %d\n", nHeight);
@@ -413,7 +435,8 @@ bool CheckSigmaTransaction(
         int nHeight,
         bool isCheckWallet,
         bool fStatefulSigmaCheck,
-        CSigmaTxInfo *sigmaTxInfo)
+        CSigmaTxInfo *sigmaTxInfo,
+        CSigmaSpendBatch *spendBatch)
 {
     Consensus::Params const & consensus = ::Params().GetConsensus();
 
@@ -492,7 +515,7 @@ bool CheckSigmaTransaction(
         if (!isVerifyDB) {
             if (!CheckSigmaSpendTransaction(
                 tx, denominations, state, hashTx, isVerifyDB, nHeight, realHeight,
-                isCheckWallet, fStatefulSigmaCheck, sigmaTxInfo)) {
+                isCheckWallet, fStatefulSigmaCheck, sigmaTxInfo, spendBatch)) {
                     return false;
             }
         }
@@ -596,9 +619,10 @@ bool ConnectBlockSigma(
         bool fJustCheck) {
     // Add zerocoin transaction information to index
     if (pblock && pblock->sigmaTxInfo) {
-        if (!fJustCheck) {
-            pindexNew->sigmaMintedPubCoins.clear();
-            pindexNew->sigmaSpentSerials.clear();
+        if (!fJustCheck && pindexNew->HasPrivacyData()) {
+            CBlockPrivacyData &privacyData = pindexNew->GetPrivacyDataForUpdate();
+            privacyData.sigmaMintedPubCoins.clear();
+            privacyData.sigmaSpentSerials.clear();
         }
 
         if (!CheckSigmaBlock(state, *pblock)) {
@@ -617,7 +641,7 @@ bool ConnectBlockSigma(
             }
 
             if (!fJustCheck) {
-                pindexNew->sigmaSpentSerials.insert(serial);
+                pindexNew->GetPrivacyDataForUpdate().sigmaSpentSerials.insert(serial);
                 sigmaState.AddSpend(serial.first, serial.second.denomination, serial.second.coinGroupId);
             }
         }
@@ -715,8 +739,9 @@ bool GetOutPoint(COutPoint& outPoint, const uint256 &pubCoinValueHash) {
     return GetOutPoint(outPoint, pubCoinValue);
 }
 
-bool BuildSigmaStateFromIndex(CChain *chain) {
-    for (CBlockIndex *blockIndex = chain->Genesis(); blockIndex; blockIndex=chain->Next(blockIndex))
+bool BuildSigmaStateFromIndex(CChain *chain, CBlockIndex *pindexSnapshot) {
+    CBlockIndex *blockIndex = pindexSnapshot ? chain->Next(pindexSnapshot) : chain->Genesis();
+    for (; blockIndex; blockIndex=chain->Next(blockIndex))
     {
         sigmaState.AddBlock(blockIndex);
     }
@@ -748,6 +773,80 @@ void CSigmaTxInfo::Complete() {
     fInfoIsComplete = true;
 }
 
+CSigmaSpendBatch::SpendGroup& CSigmaSpendBatch::GetGroup(const AnonymitySetKey &key) {
+    std::shared_ptr<SpendGroup> &group = groups[key];
+    if (!group)
+        group = std::make_shared<SpendGroup>();
+    return *group;
+}
+
+std::vector<sigma::PublicCoin>& CSigmaSpendBatch::GetAnonymitySet(const AnonymitySetKey &key) {
+    return GetGroup(key).anonymitySet;
+}
+
+void CSigmaSpendBatch::AddSpend(const AnonymitySetKey &key, std::unique_ptr<sigma::CoinSpend> spend, bool fPadding) {
+    SpendGroup &group = GetGroup(key);
+    group.spends.push_back(std::move(spend));
+    group.fPadding.push_back(fPadding);
+    nSpends++;
+}
+
+void CSigmaSpendBatch::GetChecks(std::vector<CSigmaSpendCheck> &checks, size_t nParts) const {
+    size_t nGroups = 0;
+    for (const auto &entry : groups)
+        if (!entry.second->spends.empty())
+            nGroups++;
+    if (nGroups == 0)
+        return;
+
+    // Every part costs a multi-exponentiation over the whole anonymity set, only split
+    // the groups as far as needed to keep the threads busy
+    size_t nPartsPerGroup = std::max<size_t>(1, nParts / nGroups);
+    for (const auto &entry : groups) {
+        size_t nGroupSpends = entry.second->spends.size();
+        if (nGroupSpends == 0)
+            continue;
+        size_t nGroupParts = std::min(nGroupSpends, nPartsPerGroup);
+        for (size_t i = 0; i < nGroupParts; i++) {
+            checks.emplace_back(entry.second, nGroupSpends * i / nGroupParts, nGroupSpends * (i + 1) / nGroupParts);
+        }
+    }
+}
+
+bool CSigmaSpendBatch::Verify() const {
+    std::vector<CSigmaSpendCheck> checks;
+    GetChecks(checks, 1);
+    for (CSigmaSpendCheck &check : checks) {
+        if (!check())
+            return false;
+    }
+    return true;
+}
+
+bool CSigmaSpendCheck::operator()() {
+    std::vector<const sigma::CoinSpend*> spends;
+    std::vector<bool> fPadding;
+    spends.reserve(end - begin);
+    for (size_t i = begin; i < end; i++) {
+        spends.push_back(group->spends[i].get());
+        fPadding.push_back(group->fPadding[i]);
+    }
+
+    if (sigma::CoinSpend::VerifyProofs(sigma::Params::get_default(), group->anonymitySet, spends, fPadding))
+        return true;
+
+    // find the invalid proof for the log
+    for (size_t i = 0; i < spends.size(); i++) {
+        if (spends.size() > 1 && !sigma::CoinSpend::VerifyProofs(sigma::Params::get_default(), group->anonymitySet,
+                {spends[i]}, {fPadding[i]})) {
+            LogPrintf("CSigmaSpendCheck: proof verification failed, serial=%s\n",
+                    group->spends[begin + i]->getCoinSerialNumber().tostring());
+            break;
+        }
+    }
+    return false;
+}
+
 /******************************************************************************/
 // CSigmaState::Containers
 /******************************************************************************/
@@ -877,12 +976,16 @@ void CSigmaState::AddMintsToStateAndBlockIndex(
             newCoinGroup.nCoins = mintsWithThisDenom.size();
         }
 
+        std::vector<sigma::PublicCoin> &blockMints =
+            index->GetPrivacyDataForUpdate().sigmaMintedPubCoins[{denomination, mintCoinGroupId}];
         for (const auto& mint : mintsWithThisDenom) {
             containers.AddMint(mint, CMintedCoinInfo::make(denomination, mintCoinGroupId, index->nHeight));
 
             LogPrintf("AddMintsToStateAndBlockIndex: mint added denomination=%d, id=%d\n", denomination, mintCoinGroupId);
-            index->sigmaMintedPubCoins[{denomination, mintCoinGroupId}].push_back(mint);
+            blockMints.push_back(mint);
         }
+
+        coinSets[{denomination, mintCoinGroupId}].PushBlock(index, blockMints);
     }
 }
 
@@ -893,7 +996,7 @@ void CSigmaState::AddSpend(const Scalar &serial, CoinDenomination denom, int coi
 void CSigmaState::AddBlock(CBlockIndex *index) {
     BOOST_FOREACH(
         const PAIRTYPE(PAIRTYPE(sigma::CoinDenomination, int), vector<sigma::PublicCoin>) &pubCoins,
-            index->sigmaMintedPubCoins) {
+            index->GetPrivacyData().sigmaMintedPubCoins) {
         if (!pubCoins.second.empty()) {
             SigmaCoinGroupInfo& coinGroup = coinGroups[pubCoins.first];
 
@@ -901,6 +1004,8 @@ void CSigmaState::AddBlock(CBlockIndex *index) {
                 coinGroup.firstBlock = index;
             coinGroup.lastBlock = index;
             coinGroup.nCoins += pubCoins.second.size();
+
+            coinSets[pubCoins.first].PushBlock(index, pubCoins.second);
         }
 
         latestCoinIds[pubCoins.first.first] = pubCoins.first.second;
@@ -909,7 +1014,7 @@ void CSigmaState::AddBlock(CBlockIndex *index) {
         }
     }
 
-    BOOST_FOREACH(const spend_info_container::value_type &serial, index->sigmaSpentSerials) {
+    BOOST_FOREACH(const spend_info_container::value_type &serial, index->GetPrivacyData().sigmaSpentSerials) {
         AddSpend(serial.first, serial.second.denomination, serial.second.coinGroupId);
     }
 }
@@ -918,16 +1023,21 @@ void CSigmaState::RemoveBlock(CBlockIndex *index) {
     // roll back accumulator updates
     BOOST_FOREACH(
         const PAIRTYPE(PAIRTYPE(sigma::CoinDenomination, int),vector<sigma::PublicCoin>) &coin,
-        index->sigmaMintedPubCoins)
+        index->GetPrivacyData().sigmaMintedPubCoins)
     {
         SigmaCoinGroupInfo   &coinGroup = coinGroups[coin.first];
         int  nMintsToForget = coin.second.size();
 
         assert(coinGroup.nCoins >= nMintsToForget);
 
+        auto coinSet = coinSets.find(coin.first);
+        if (coinSet != coinSets.end() && coinSet->second.GetLastBlock() == index)
+            coinSet->second.PopBlock();
+
         if ((coinGroup.nCoins -= nMintsToForget) == 0) {
             // all the coins of this group have been erased, remove the group altogether
             coinGroups.erase(coin.first);
+            coinSets.erase(coin.first);
             // decrease pubcoin id for this denomination
             latestCoinIds[coin.first.first]--;
             if (0 == latestCoinIds[coin.first.first]) {
@@ -941,13 +1051,13 @@ void CSigmaState::RemoveBlock(CBlockIndex *index) {
             do {
                 assert(coinGroup.lastBlock != coinGroup.firstBlock);
                 coinGroup.lastBlock = coinGroup.lastBlock->pprev;
-            } while (coinGroup.lastBlock->sigmaMintedPubCoins.count(coin.first) == 0);
+            } while (coinGroup.lastBlock->GetPrivacyData().sigmaMintedPubCoins.count(coin.first) == 0);
         }
     }
 
     // roll back mints
     BOOST_FOREACH(const PAIRTYPE(PAIRTYPE(sigma::CoinDenomination, int),vector<sigma::PublicCoin>) &pubCoins,
-                  index->sigmaMintedPubCoins) {
+                  index->GetPrivacyData().sigmaMintedPubCoins) {
         BOOST_FOREACH(const sigma::PublicCoin &coin, pubCoins.second) {
             auto coins = containers.GetMints().equal_range(coin);
             auto coinIt = find_if(
@@ -962,7 +1072,7 @@ void CSigmaState::RemoveBlock(CBlockIndex *index) {
     }
 
     // roll back spends
-    BOOST_FOREACH(const spend_info_container::value_type &serial, index->sigmaSpentSerials) {
+    BOOST_FOREACH(const spend_info_container::value_type &serial, index->GetPrivacyData().sigmaSpentSerials) {
         containers.RemoveSpend(serial.first);
     }
 }
@@ -1021,35 +1131,92 @@ int CSigmaState::GetCoinSetForSpend(
 
     pair<sigma::CoinDenomination, int> denomAndId = std::make_pair(denomination, coinGroupID);
 
-    if (coinGroups.count(denomAndId) == 0)
+    auto coinGroup = coinGroups.find(denomAndId);
+    if (coinGroup == coinGroups.end())
         return 0;
 
-    SigmaCoinGroupInfo coinGroup = coinGroups[denomAndId];
-
-    int numberOfCoins = 0;
-    for (CBlockIndex *block = coinGroup.lastBlock;
-            ;
-            block = block->pprev) {
-        if (block->sigmaMintedPubCoins[denomAndId].size() > 0) {
-            if (block->nHeight <= maxHeight) {
-                if (numberOfCoins == 0) {
-                    // latest block satisfying given conditions
-                    // remember block hash
-                    blockHash_out = block->GetBlockHash();
-                }
-                numberOfCoins += block->sigmaMintedPubCoins[denomAndId].size();
-                coins_out.insert(coins_out.end(),
-                        block->sigmaMintedPubCoins[denomAndId].begin(),
-                        block->sigmaMintedPubCoins[denomAndId].end());
-            }
-        }
-        if (block == coinGroup.firstBlock) {
-            break ;
-        }
-    }
+    const CoinSet &coinSet = GetCoinSet(denomAndId, coinGroup->second);
+
+    // the coins of the blocks up to maxHeight are the oldest ones of the set
+    const CBlockIndex *block;
+    std::size_t numberOfCoins = coinSet.GetCoinCount(maxHeight, block);
+    if (numberOfCoins == 0)
+        return 0;
+
+    // latest block satisfying given conditions
+    blockHash_out = block->GetBlockHash();
+    const sigma::PublicCoin *coins = coinSet.GetCoins(numberOfCoins);
+    coins_out.assign(coins, coins + numberOfCoins);
     return numberOfCoins;
 }
 
+const CSigmaState::CoinSet& CSigmaState::GetCoinSet(
+        const pair<CoinDenomination, int> &denomAndId,
+        const SigmaCoinGroupInfo &coinGroup) {
+    CoinSet &coinSet = coinSets[denomAndId];
+    if (coinSet.GetLastBlock() == coinGroup.lastBlock && coinSet.GetCoinCount() == (std::size_t)coinGroup.nCoins)
+        return coinSet;
+
+    // the group was changed without its set, rebuild it from the index
+    std::vector<const CBlockIndex *> blocks;
+    for (const CBlockIndex *block = coinGroup.lastBlock; ; block = block->pprev) {
+        blocks.push_back(block);
+        if (block == coinGroup.firstBlock)
+            break;
+    }
+
+    coinSet = CoinSet();
+    for (auto block = blocks.rbegin(); block != blocks.rend(); ++block) {
+        const auto &blockMints = (*block)->GetPrivacyData().sigmaMintedPubCoins;
+        auto coins = blockMints.find(denomAndId);
+        if (coins != blockMints.end())
+            coinSet.PushBlock(*block, coins->second);
+    }
+    return coinSet;
+}
+
+void CSigmaState::CoinSet::PushBlock(const CBlockIndex *index, const std::vector<sigma::PublicCoin> &coins) {
+    // mints added to the newest block again replace its coins
+    if (!blocks.empty() && blocks.back().first == index)
+        PopBlock();
+    if (coins.empty())
+        return;
+    assert(blocks.empty() || blocks.back().first->nHeight < index->nHeight);
+
+    if (begin < coins.size()) {
+        // make room in front of the set, keeping it at the back of the buffer
+        std::size_t count = GetCoinCount();
+        std::size_t newSize = std::max(2 * buffer.size(), count + coins.size());
+        std::vector<sigma::PublicCoin> newBuffer(newSize);
+        std::copy(buffer.begin() + begin, buffer.end(), newBuffer.end() - count);
+        buffer.swap(newBuffer);
+        begin = newSize - count;
+    }
+
+    begin -= coins.size();
+    std::copy(coins.begin(), coins.end(), buffer.begin() + begin);
+    blocks.emplace_back(index, GetCoinCount());
+}
+
+void CSigmaState::CoinSet::PopBlock() {
+    assert(!blocks.empty());
+    std::size_t previousCount = blocks.size() > 1 ? blocks[blocks.size() - 2].second : 0;
+    begin += blocks.back().second - previousCount;
+    blocks.pop_back();
+}
+
+std::size_t CSigmaState::CoinSet::GetCoinCount(int maxHeight, const CBlockIndex *&block_out) const {
+    auto block = std::upper_bound(blocks.begin(), blocks.end(), maxHeight,
+        [](int height, const std::pair<const CBlockIndex *, std::size_t> &b) {
+            return height < b.first->nHeight;
+        });
+    if (block == blocks.begin())
+        return 0;
+    --block;
+    block_out = block->first;
+    return block->second;
+}
+
 std::pair<int, int> CSigmaState::GetMintedCoinHeightAndId(
         const sigma::PublicCoin& pubCoin) {
     auto coinIt = containers.GetMints().find(pubCoin);
@@ -1110,12 +1277,75 @@ bool CSigmaState::CanAddMintToMempool(const GroupElement& pubCoin){
 
 void CSigmaState::Reset() {
     coinGroups.clear();
+    coinSets.clear();
     latestCoinIds.clear();
     mempoolCoinSerials.clear();
     mempoolMints.clear();
     containers.Reset();
 }
 
+void CSigmaState::WriteSnapshot(CDataStream &s) const {
+    WriteCompactSize(s, coinGroups.size());
+    for (const auto &coinGroup : coinGroups) {
+        s << (int64_t)coinGroup.first.first << coinGroup.first.second;
+        WriteStateSnapshotBlock(s, coinGroup.second.firstBlock);
+        WriteStateSnapshotBlock(s, coinGroup.second.lastBlock);
+        s << coinGroup.second.nCoins;
+    }
+
+    WriteCompactSize(s, latestCoinIds.size());
+    for (const auto &latestId : latestCoinIds)
+        s << (int64_t)latestId.first << latestId.second;
+
+    // coin sets are rebuilt from the index when first used
+    WriteCompactSize(s, containers.GetMints().size());
+    for (const auto &mint : containers.GetMints())
+        s << mint.first << (int64_t)mint.second.denomination << mint.second.coinGroupId << mint.second.nHeight;
+
+    WriteCompactSize(s, containers.GetSpends().size());
+    for (const auto &spend : containers.GetSpends())
+        s << spend.first << spend.second;
+}
+
+bool CSigmaState::ReadSnapshot(CDataStream &s) {
+    Reset();
+
+    for (uint64_t n = ReadCompactSize(s); n > 0; n--) {
+        int64_t denomination;
+        int id;
+        SigmaCoinGroupInfo coinGroup;
+        s >> denomination >> id;
+        if (!ReadStateSnapshotBlock(s, coinGroup.firstBlock) || !ReadStateSnapshotBlock(s, coinGroup.lastBlock))
+            return false;
+        s >> coinGroup.nCoins;
+        coinGroups[{CoinDenomination(denomination), id}] = coinGroup;
+    }
+
+    for (uint64_t n = ReadCompactSize(s); n > 0; n--) {
+        int64_t denomination;
+        int id;
+        s >> denomination >> id;
+        latestCoinIds[CoinDenomination(denomination)] = id;
+    }
+
+    for (uint64_t n = ReadCompactSize(s); n > 0; n--) {
+        sigma::PublicCoin pubCoin;
+        int64_t denomination;
+        int id, nHeight;
+        s >> pubCoin >> denomination >> id >> nHeight;
+        containers.AddMint(pubCoin, CMintedCoinInfo::make(CoinDenomination(denomination), id, nHeight));
+    }
+
+    for (uint64_t n = ReadCompactSize(s); n > 0; n--) {
+        Scalar serial;
+        CSpendCoinInfo spendInfo;
+        s >> serial >> spendInfo;
+        containers.AddSpend(serial, spendInfo);
+    }
+
+    return true;
+}
+
 CSigmaState* CSigmaState::GetState() {
     return &sigmaState;
 }
@@ -12,6 +12,9 @@
 #include <unordered_set>
 #include <unordered_map>
 #include <functional>
+#include <map>
+#include <memory>
+#include <tuple>
 #include "coin_containers.h"
 
 //tests
@@ -44,6 +47,65 @@ public:
     void Complete();
 };
 
+class CSigmaSpendCheck;
+
+// Sigma spend proofs of a block, collected while its transactions are checked. Proofs over the
+// same anonymity set are verified together in one multi-exponentiation after the last transaction.
+class CSigmaSpendBatch {
+public:
+    // Anonymity set is identified by denomination, coin group id and the last block of the set
+    typedef std::tuple<sigma::CoinDenomination, int, const CBlockIndex *> AnonymitySetKey;
+
+    struct SpendGroup {
+        std::vector<sigma::PublicCoin> anonymitySet;
+        std::vector<std::unique_ptr<sigma::CoinSpend>> spends;
+        std::vector<bool> fPadding;
+    };
+
+    // Anonymity set for the key, empty if it was not filled in yet
+    std::vector<sigma::PublicCoin>& GetAnonymitySet(const AnonymitySetKey &key);
+
+    // Defer verification of the spend proof, its signature must have been verified already
+    void AddSpend(const AnonymitySetKey &key, std::unique_ptr<sigma::CoinSpend> spend, bool fPadding);
+
+    // Split the proofs into at least nParts checks where there are enough of them, one
+    // batch per check. The checks share the spends, the batch must outlive them.
+    void GetChecks(std::vector<CSigmaSpendCheck> &checks, size_t nParts) const;
+
+    // Verify all the proofs on the calling thread
+    bool Verify() const;
+
+    size_t GetSpendCount() const { return nSpends; }
+
+private:
+    SpendGroup& GetGroup(const AnonymitySetKey &key);
+
+    std::map<AnonymitySetKey, std::shared_ptr<SpendGroup>> groups;
+    size_t nSpends = 0;
+};
+
+// Verification of a range of the proofs of a group in CSigmaSpendBatch, run on the check queue
+// threads like CScriptCheck. When the batch fails its proofs are verified one by one to find the culprit.
+class CSigmaSpendCheck {
+public:
+    CSigmaSpendCheck(): begin(0), end(0) {}
+    CSigmaSpendCheck(std::shared_ptr<const CSigmaSpendBatch::SpendGroup> groupIn, size_t beginIn, size_t endIn) :
+        group(std::move(groupIn)), begin(beginIn), end(endIn) {}
+
+    bool operator()();
+
+    void swap(CSigmaSpendCheck &check) {
+        group.swap(check.group);
+        std::swap(begin, check.begin);
+        std::swap(end, check.end);
+    }
+
+private:
+    std::shared_ptr<const CSigmaSpendBatch::SpendGroup> group;
+    size_t begin;
+    size_t end;
+};
+
 bool IsSigmaAllowed();
 bool IsSigmaAllowed(int height);
 
@@ -63,7 +125,8 @@ bool CheckSigmaTransaction(
 	int nHeight,
   bool isCheckWallet,
   bool fStatefulSigmaCheck,
-  CSigmaTxInfo *zerocoinTxInfo);
+  CSigmaTxInfo *zerocoinTxInfo,
+  CSigmaSpendBatch *spendBatch = NULL);
 
 void DisconnectTipSigma(CBlock &block, CBlockIndex *pindexDelete);
 
@@ -82,7 +145,9 @@ bool GetOutPoint(COutPoint& outPoint, const sigma::PublicCoin &pubCoin);
 bool GetOutPoint(COutPoint& outPoint, const GroupElement &pubCoinValue);
 bool GetOutPoint(COutPoint& outPoint, const uint256 &pubCoinValueHash);
 
-bool BuildSigmaStateFromIndex(CChain *chain);
+// Add the blocks of the chain to the state. With pindexSnapshot, the state has been read from a snapshot
+// taken at that block and only the blocks after it are added
+bool BuildSigmaStateFromIndex(CChain *chain, CBlockIndex *pindexSnapshot = NULL);
 
 Scalar GetSigmaSpendSerialNumber(const CTransaction &tx, const CTxIn &txin);
 CAmount GetSigmaSpendInput(const CTransaction &tx);
@@ -158,6 +223,11 @@ public:
     // Reset to initial values
     void Reset();
 
+    // Write the state of the blockchain part (not the mempool) to a snapshot
+    void WriteSnapshot(CDataStream &s) const;
+    // Read the state from a snapshot. Returns false if its blocks aren't in the active chain
+    bool ReadSnapshot(CDataStream &s);
+
     // Check if there is a conflicting tx in the blockchain or mempool
     bool CanAddSpendToMempool(const Scalar& coinSerial);
 
@@ -211,6 +281,39 @@ private:
 
     std::atomic<bool> surgeCondition;
 
+    // Coins of a group in the order spends prove membership in: newest block first, block
+    // order within a block. The buffer is filled from the back, so the coins minted up to any
+    // block of the group are a contiguous tail of it and blocks are added without copying the set.
+    class CoinSet {
+    public:
+        CoinSet() : begin(0) {}
+
+        // Add the coins of a block newer than the ones already in the set
+        void PushBlock(const CBlockIndex *index, const std::vector<sigma::PublicCoin> &coins);
+        // Remove the coins of the newest block
+        void PopBlock();
+
+        const CBlockIndex *GetLastBlock() const { return blocks.empty() ? NULL : blocks.back().first; }
+        std::size_t GetCoinCount() const { return buffer.size() - begin; }
+
+        // Number of coins minted up to maxHeight, block_out is the newest block having some
+        std::size_t GetCoinCount(int maxHeight, const CBlockIndex *&block_out) const;
+        // The `count` oldest coins, laid out as GetCoinSetForSpend returns them
+        const sigma::PublicCoin *GetCoins(std::size_t count) const { return buffer.data() + buffer.size() - count; }
+
+    private:
+        std::vector<sigma::PublicCoin> buffer;
+        std::size_t begin;
+        // blocks of the group oldest first, with the number of coins up to and including them
+        std::vector<std::pair<const CBlockIndex *, std::size_t>> blocks;
+    };
+
+    // Coin sets of the groups, kept up to date as blocks are added and removed
+    std::unordered_map<pair<CoinDenomination, int>, CoinSet, pairhash> coinSets;
+
+    // Return the coin set of the group, rebuilding it from the index if it is out of date
+    const CoinSet &GetCoinSet(const pair<CoinDenomination, int> &denomAndId, const SigmaCoinGroupInfo &coinGroup);
+
     struct Containers {
         Containers(std::atomic<bool> & surgeCondition);
 
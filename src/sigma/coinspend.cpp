@@ -98,7 +98,11 @@ bool CoinSpend::Verify(
         const std::vector<sigma::PublicCoin>& anonymity_set,
         const SpendMetaData& m,
         bool fPadding) const {
-    SigmaPlusVerifier<Scalar, GroupElement> sigmaVerifier(params->get_g(), params->get_h(), params->get_n(), params->get_m());
+    if (!VerifySignature(m))
+        return false;
+
+    SigmaPlusVerifier<Scalar, GroupElement> sigmaVerifier(params->get_g(), params->get_h(), params->get_n(), params->get_m(),
+                                                          &params->get_gens_table());
     //compute inverse of g^s
     GroupElement gs = (params->get_g() * coinSerialNumber).inverse();
     std::vector<GroupElement> C_;
@@ -106,6 +110,11 @@ bool CoinSpend::Verify(
     for(std::size_t j = 0; j < anonymity_set.size(); ++j)
         C_.emplace_back(anonymity_set[j].getValue() + gs);
 
+    // Now verify the sigma proof itself.
+    return sigmaVerifier.verify(C_, sigmaProof, fPadding);
+}
+
+bool CoinSpend::VerifySignature(const SpendMetaData& m) const {
     uint256 metahash = signatureHash(m);
 
     // Verify ecdsa_signature, to make sure someone did not change the output of transaction.
@@ -141,8 +150,32 @@ bool CoinSpend::Verify(
         return false;
     }
 
-    // Now verify the sigma proof itself.
-    return sigmaVerifier.verify(C_, sigmaProof, fPadding);
+    return true;
+}
+
+bool CoinSpend::VerifyProofs(
+        const Params* p,
+        const std::vector<sigma::PublicCoin>& anonymity_set,
+        const std::vector<const CoinSpend*>& spends,
+        const std::vector<bool>& fPadding) {
+    SigmaPlusVerifier<Scalar, GroupElement> sigmaVerifier(p->get_g(), p->get_h(), p->get_n(), p->get_m(),
+                                                          &p->get_gens_table());
+
+    std::vector<GroupElement> C_;
+    C_.reserve(anonymity_set.size());
+    for (const sigma::PublicCoin& coin : anonymity_set)
+        C_.emplace_back(coin.getValue());
+
+    std::vector<Scalar> serials;
+    std::vector<const SigmaPlusProof<Scalar, GroupElement>*> proofs;
+    serials.reserve(spends.size());
+    proofs.reserve(spends.size());
+    for (const CoinSpend* spend : spends) {
+        serials.emplace_back(spend->coinSerialNumber);
+        proofs.emplace_back(&spend->sigmaProof);
+    }
+
+    return sigmaVerifier.batch_verify(C_, serials, fPadding, proofs);
 }
 
 const Scalar& CoinSpend::getCoinSerialNumber() {
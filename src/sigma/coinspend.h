@@ -52,6 +52,16 @@ public:
 
     bool Verify(const std::vector<sigma::PublicCoin>& anonymity_set, const SpendMetaData &m, bool fPadding) const;
 
+    // Everything Verify() checks except the sigma proof: serial number and ecdsa signature.
+    bool VerifySignature(const SpendMetaData &m) const;
+
+    // Checks only the sigma proofs of several spends over the same anonymity set, in one batch.
+    static bool VerifyProofs(
+        const Params* p,
+        const std::vector<sigma::PublicCoin>& anonymity_set,
+        const std::vector<const CoinSpend*>& spends,
+        const std::vector<bool>& fPadding);
+
     ADD_SERIALIZE_METHODS;
     template <typename Stream, typename Operation>
     void SerializationOp(Stream& s, Operation ser_action) {
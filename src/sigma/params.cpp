@@ -47,6 +47,12 @@ Params::Params(const GroupElement& g, int n, int m) :
         h_[i - 1].sha256(buff);
         h_[i].generate(buff);
     }
+
+    std::vector<GroupElement> gens;
+    gens.reserve(h_.size() + 1);
+    gens.emplace_back(g_);
+    gens.insert(gens.end(), h_.begin(), h_.end());
+    gens_table_.reset(new PrecomputedMultiExponent(gens));
 }
 
 Params::~Params(){
@@ -64,6 +70,10 @@ const std::vector<GroupElement>& Params::get_h() const{
     return h_;
 }
 
+const PrecomputedMultiExponent& Params::get_gens_table() const{
+    return *gens_table_;
+}
+
 uint64_t Params::get_n() const{
     return n_;
 }
@@ -2,8 +2,11 @@
 #define ZCOIN_SIGMA_PARAMS_H
 #include <secp256k1/include/Scalar.h>
 #include <secp256k1/include/GroupElement.h>
+#include <secp256k1/include/PrecomputedMultiExponent.h>
 #include <serialize.h>
 
+#include <memory>
+
 using namespace secp_primitives;
 
 namespace sigma {
@@ -14,6 +17,8 @@ public:
     const GroupElement& get_g() const;
     const GroupElement& get_h0() const;
     const std::vector<GroupElement>& get_h() const;
+    // Fixed-base tables of g followed by h, for proof verification
+    const PrecomputedMultiExponent& get_gens_table() const;
     uint64_t get_n() const;
     uint64_t get_m() const;
 
@@ -25,6 +30,7 @@ private:
     static Params* instance;
     GroupElement g_;
     std::vector<GroupElement> h_;
+    std::unique_ptr<PrecomputedMultiExponent> gens_table_;
     int m_;
     int n_;
 };
@@ -1,15 +1,19 @@
 #ifndef ZCOIN_SIGMA_R1_PROOF_VERIFIER_H
 #define ZCOIN_SIGMA_R1_PROOF_VERIFIER_H
 
+#include "../secp256k1/include/PrecomputedMultiExponent.h"
+
 namespace sigma {
 
 template <class Exponent, class GroupElement>
 class R1ProofVerifier {
 
 public:
+    // gens_table, if given, holds the multiples of g followed by h_gens
     R1ProofVerifier(const GroupElement& g,
             const std::vector<GroupElement>& h_gens,
-            const GroupElement& B, int n , int m);
+            const GroupElement& B, int n , int m,
+            const secp_primitives::PrecomputedMultiExponent* gens_table = nullptr);
 
     bool verify(const R1Proof<Exponent, GroupElement>& proof,
                 bool skip_final_response_verification = false) const;
@@ -23,12 +27,17 @@ public:
             const Exponent& challenge_x,
             std::vector<Exponent>& f_out) const;
 
+private:
+    // g * r + sum h_[i] * exp[i]
+    GroupElement commit(const std::vector<Exponent>& exp, const Exponent& r) const;
+
 private:
     const GroupElement& g_;
     const std::vector<GroupElement>& h_;
     GroupElement B_Commit;
     int n_;
     int m_;
+    const secp_primitives::PrecomputedMultiExponent* gens_table_;
 };
 
 } // namespace sigma
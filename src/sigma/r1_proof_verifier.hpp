@@ -6,12 +6,14 @@ R1ProofVerifier<Exponent,GroupElement>::R1ProofVerifier(
         const std::vector<GroupElement>& h_gens,
         const GroupElement& B,
         int n ,
-        int m)
+        int m,
+        const secp_primitives::PrecomputedMultiExponent* gens_table)
     : g_(g)
     , h_(h_gens)
     , B_Commit(B)
     , n_(n)
-    , m_(m){
+    , m_(m)
+    , gens_table_(gens_table){
 }
 
 template<class Exponent, class GroupElement>
@@ -83,8 +85,7 @@ bool R1ProofVerifier<Exponent,GroupElement>::verify_final_response(
         f_out[j * n_] = challenge_x - temp;
     }
 
-    GroupElement one;
-    SigmaPrimitives<Exponent, GroupElement>::commit(g_, h_, f_out, proof.ZA_, one);
+    GroupElement one = commit(f_out, proof.ZA_);
     if((B_Commit * challenge_x + proof.A_) != one)
         return false;
 
@@ -94,12 +95,23 @@ bool R1ProofVerifier<Exponent,GroupElement>::verify_final_response(
         f_outprime.emplace_back(f_out[i] * (challenge_x - f_out[i]));
     }
 
-    GroupElement two;
-    SigmaPrimitives<Exponent, GroupElement>::commit(g_, h_, f_outprime, proof.ZC_, two);
+    GroupElement two = commit(f_outprime, proof.ZC_);
     if ((proof.C_ * challenge_x + proof.D_) != two)
         return false;
 
     return true;
 }
+
+template<class Exponent, class GroupElement>
+GroupElement R1ProofVerifier<Exponent,GroupElement>::commit(
+            const std::vector<Exponent>& exp,
+            const Exponent& r) const {
+    GroupElement result;
+    if (gens_table_)
+        result = gens_table_->get_multiple(0, r) + gens_table_->get_multiple(exp, 1);
+    else
+        SigmaPrimitives<Exponent, GroupElement>::commit(g_, h_, exp, r, result);
+    return result;
+}
  
 } // namespace sigma
@@ -9,19 +9,45 @@ template<class Exponent, class GroupElement>
 class SigmaPlusVerifier{
 
 public:
+    // gens_table, if given, holds the multiples of g followed by h_gens and is used
+    // instead of generic multiplications of the generators
     SigmaPlusVerifier(const GroupElement& g,
                       const std::vector<GroupElement>& h_gens,
-                      int n, int m_);
+                      int n, int m_,
+                      const secp_primitives::PrecomputedMultiExponent* gens_table = nullptr);
 
     bool verify(const std::vector<GroupElement>& commits,
                 const SigmaPlusProof<Exponent, GroupElement>& proof,
                 bool fPadding) const;
 
+    /** Verify several proofs over the same set of commitments at once.
+     *  Proof k is checked against commits[i] - g * serials[k], the final equations of all
+     *  proofs are combined with random weights into a single multi-exponentiation. If this
+     *  returns false at least one of the proofs is invalid, use verify() to find which.
+     */
+    bool batch_verify(const std::vector<GroupElement>& commits,
+                      const std::vector<Exponent>& serials,
+                      const std::vector<bool>& fPadding,
+                      const std::vector<const SigmaPlusProof<Exponent, GroupElement>*>& proofs) const;
+
 private:
+    //! Checks of a proof which do not depend on the commitments, computes challenge x and f
+    bool verify_proof_elements(const SigmaPlusProof<Exponent, GroupElement>& proof,
+                               Exponent& challenge_x,
+                               std::vector<Exponent>& f) const;
+
+    //! Computes the power of each of the N commitments in the final equation
+    void compute_commit_powers(std::size_t N,
+                               bool fPadding,
+                               const Exponent& challenge_x,
+                               const std::vector<Exponent>& f,
+                               std::vector<Exponent>& f_i_) const;
+
     GroupElement g_;
     std::vector<GroupElement> h_;
     int n;
     int m;
+    const secp_primitives::PrecomputedMultiExponent* gens_table_;
 };
 
 } // namespace sigma
@@ -5,11 +5,13 @@ SigmaPlusVerifier<Exponent, GroupElement>::SigmaPlusVerifier(
         const GroupElement& g,
         const std::vector<GroupElement>& h_gens,
         int n,
-        int m)
+        int m,
+        const secp_primitives::PrecomputedMultiExponent* gens_table)
     : g_(g)
     , h_(h_gens)
     , n(n)
-    , m(m){
+    , m(m)
+    , gens_table_(gens_table){
 }
 
 template<class Exponent, class GroupElement>
@@ -18,8 +20,127 @@ bool SigmaPlusVerifier<Exponent, GroupElement>::verify(
         const SigmaPlusProof<Exponent, GroupElement>& proof,
         bool fPadding) const {
 
-    R1ProofVerifier<Exponent, GroupElement> r1ProofVerifier(g_, h_, proof.B_, n, m);
+    Exponent challenge_x;
     std::vector<Exponent> f;
+    if (!verify_proof_elements(proof, challenge_x, f))
+        return false;
+
+    if (commits.empty()) {
+        LogPrintf("No mints in the anonymity set");
+        return false;
+    }
+
+    std::vector<Exponent> f_i_;
+    compute_commit_powers(commits.size(), fPadding, challenge_x, f, f_i_);
+
+    secp_primitives::MultiExponent mult(commits, f_i_);
+    GroupElement t1 = mult.get_multiple();
+
+    const std::vector <GroupElement>& Gk = proof.Gk_;
+    GroupElement t2;
+    Exponent x_k(uint64_t(1));
+    for(int k = 0; k < m; ++k){
+        t2 += (Gk[k] * (x_k.negate()));
+        x_k *= challenge_x;
+    }
+
+    GroupElement left(t1 + t2);
+    GroupElement right = gens_table_ ? gens_table_->get_multiple(1, proof.z_)
+        : SigmaPrimitives<Exponent, GroupElement>::commit(g_, Exponent(uint64_t(0)), h_[0], proof.z_);
+    if (left != right) {
+        LogPrintf("Sigma spend failed due to final proof verification failure.");
+        return false;
+    }
+
+    return true;
+}
+
+template<class Exponent, class GroupElement>
+bool SigmaPlusVerifier<Exponent, GroupElement>::batch_verify(
+        const std::vector<GroupElement>& commits,
+        const std::vector<Exponent>& serials,
+        const std::vector<bool>& fPadding,
+        const std::vector<const SigmaPlusProof<Exponent, GroupElement>*>& proofs) const {
+
+    assert(serials.size() == proofs.size() && fPadding.size() == proofs.size());
+
+    if (commits.empty()) {
+        LogPrintf("No mints in the anonymity set");
+        return false;
+    }
+
+    /*
+     * For every proof k the final equation is
+     *
+     *   \sum_i f_{k,i} (C_i - s_k g) - \sum_j x_k^j G_{k,j} - z_k h_0 = 0
+     *
+     * Each equation is multiplied by a random y_k and all of them are summed, so
+     * the commitments, g and h_0 get a single combined power each.
+     */
+    std::size_t N = commits.size();
+    std::vector<GroupElement> gens(commits);
+    std::vector<Exponent> powers(N, Exponent(uint64_t(0)));
+    gens.reserve(N + 2 + proofs.size() * m);
+    powers.reserve(N + 2 + proofs.size() * m);
+
+    Exponent g_power(uint64_t(0)), h_power(uint64_t(0));
+    std::vector<Exponent> f_i_;
+    for (std::size_t k = 0; k < proofs.size(); ++k) {
+        const SigmaPlusProof<Exponent, GroupElement>& proof = *proofs[k];
+
+        Exponent challenge_x;
+        std::vector<Exponent> f;
+        if (!verify_proof_elements(proof, challenge_x, f))
+            return false;
+
+        compute_commit_powers(N, fPadding[k], challenge_x, f, f_i_);
+
+        Exponent y;
+        y.randomize();
+
+        Exponent f_sum(uint64_t(0));
+        for (std::size_t i = 0; i < N; ++i) {
+            Exponent yf = y * f_i_[i];
+            powers[i] += yf;
+            f_sum += yf;
+        }
+        g_power -= f_sum * serials[k];
+        h_power -= y * proof.z_;
+
+        Exponent x_j(uint64_t(1));
+        for (int j = 0; j < m; ++j) {
+            gens.emplace_back(proof.Gk_[j]);
+            powers.emplace_back((y * x_j).negate());
+            x_j *= challenge_x;
+        }
+    }
+
+    GroupElement fixed_part;
+    if (gens_table_) {
+        fixed_part = gens_table_->get_multiple({g_power, h_power});
+    } else {
+        gens.emplace_back(g_);
+        powers.emplace_back(g_power);
+        gens.emplace_back(h_[0]);
+        powers.emplace_back(h_power);
+    }
+
+    secp_primitives::MultiExponent mult(gens, powers);
+    if (!(mult.get_multiple() + fixed_part).isInfinity()) {
+        LogPrintf("Sigma spend batch of %d proofs failed final proof verification.\n", proofs.size());
+        return false;
+    }
+
+    return true;
+}
+
+template<class Exponent, class GroupElement>
+bool SigmaPlusVerifier<Exponent, GroupElement>::verify_proof_elements(
+        const SigmaPlusProof<Exponent, GroupElement>& proof,
+        Exponent& challenge_x,
+        std::vector<Exponent>& f) const {
+
+    R1ProofVerifier<Exponent, GroupElement> r1ProofVerifier(g_, h_, proof.B_, n, m, gens_table_);
     const R1Proof<Exponent, GroupElement>& r1Proof = proof.r1Proof_;
     if (!r1ProofVerifier.verify(r1Proof, f, true /* Skip verification of final response */)) {
         LogPrintf("Sigma spend failed due to r1 proof incorrect.");
@@ -44,7 +165,6 @@ bool SigmaPlusVerifier<Exponent, GroupElement>::verify(
         r1Proof.A_, proof.B_, r1Proof.C_, r1Proof.D_};
 
     group_elements.insert(group_elements.end(), Gk.begin(), Gk.end());
-    Exponent challenge_x;
     SigmaPrimitives<Exponent, GroupElement>::generate_challenge(group_elements, challenge_x);
 
     // Now verify the final response of r1 proof. Values of "f" are finalized only after this call.
@@ -58,13 +178,18 @@ bool SigmaPlusVerifier<Exponent, GroupElement>::verify(
         return false;
     }
 
-    if (commits.empty()) {
-        LogPrintf("No mints in the anonymity set");
-        return false;
-    }
+    return true;
+}
 
-    std::size_t N = commits.size();
-    std::vector<Exponent> f_i_;
+template<class Exponent, class GroupElement>
+void SigmaPlusVerifier<Exponent, GroupElement>::compute_commit_powers(
+        std::size_t N,
+        bool fPadding,
+        const Exponent& challenge_x,
+        const std::vector<Exponent>& f,
+        std::vector<Exponent>& f_i_) const {
+
+    f_i_.clear();
     f_i_.reserve(N);
 
     // if fPadding is true last index is special
@@ -111,24 +236,6 @@ bool SigmaPlusVerifier<Exponent, GroupElement>::verify(
         }
         f_i_.emplace_back(pow);
     }
-
-    secp_primitives::MultiExponent mult(commits, f_i_);
-    GroupElement t1 = mult.get_multiple();
-
-    GroupElement t2;
-    Exponent x_k(uint64_t(1));
-    for(int k = 0; k < m; ++k){
-        t2 += (Gk[k] * (x_k.negate()));
-        x_k *= challenge_x;
-    }
-
-    GroupElement left(t1 + t2);
-    if (left != SigmaPrimitives<Exponent, GroupElement>::commit(g_, Exponent(uint64_t(0)), h_[0], proof.z_)) {
-        LogPrintf("Sigma spend failed due to final proof verification failure.");
-        return false;
-    }
-
-    return true;
 }
 
 } // namespace sigma
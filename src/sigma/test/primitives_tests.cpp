@@ -1,6 +1,8 @@
 #include "../sigma_primitives.h"
 
 #include "../../secp256k1/include/GroupElement.h"
+#include "../../secp256k1/include/MultiExponent.h"
+#include "../../secp256k1/include/PrecomputedMultiExponent.h"
 #include "../../secp256k1/include/Scalar.h"
 
 #include <boost/test/unit_test.hpp>
@@ -169,4 +171,30 @@ BOOST_AUTO_TEST_CASE(commit2_homomorphic_test)
     BOOST_CHECK(t1+t2 == t3);
 }
 
+BOOST_AUTO_TEST_CASE(precomputed_multiexponent_test)
+{
+    std::vector<secp_primitives::GroupElement> gens(5);
+    for (auto& gen : gens)
+        gen.randomize();
+    secp_primitives::PrecomputedMultiExponent table(gens);
+    BOOST_CHECK(table.size() == gens.size());
+
+    std::vector<secp_primitives::Scalar> powers(3);
+    for (auto& power : powers)
+        power.randomize();
+
+    // single generators, including the zero and one exponents
+    for (std::size_t i = 0; i < gens.size(); ++i) {
+        BOOST_CHECK(table.get_multiple(i, powers[0]) == gens[i] * powers[0]);
+        BOOST_CHECK(table.get_multiple(i, secp_primitives::Scalar(uint64_t(1))) == gens[i]);
+        BOOST_CHECK(table.get_multiple(i, secp_primitives::Scalar(uint64_t(0))).isInfinity());
+    }
+
+    // a run of generators starting at an offset
+    std::vector<secp_primitives::GroupElement> head(gens.begin(), gens.begin() + 3);
+    std::vector<secp_primitives::GroupElement> tail(gens.begin() + 2, gens.end());
+    BOOST_CHECK(table.get_multiple(powers) == secp_primitives::MultiExponent(head, powers).get_multiple());
+    BOOST_CHECK(table.get_multiple(powers, 2) == secp_primitives::MultiExponent(tail, powers).get_multiple());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
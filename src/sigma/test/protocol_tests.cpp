@@ -209,4 +209,69 @@ BOOST_AUTO_TEST_CASE(prove_coin_not_in_set)
     BOOST_CHECK(!verifier.verify(commits, proof, true));
 }
 
+BOOST_AUTO_TEST_CASE(batch_verify)
+{
+    auto params = sigma::Params::get_default();
+    int N = 1000;
+    int n = params->get_n();
+    int m = params->get_m();
+    std::vector<int> indexes = {0, 500, N - 1};
+
+    secp_primitives::GroupElement g;
+    g.randomize();
+    std::vector<secp_primitives::GroupElement> h_gens;
+    h_gens.resize(n * m);
+    for(int i = 0; i < n * m; ++i ){
+        h_gens[i].randomize();
+    }
+    sigma::SigmaPlusProver<secp_primitives::Scalar,secp_primitives::GroupElement> prover(g,h_gens, n, m);
+
+    std::vector<secp_primitives::GroupElement> commits(N);
+    for(int i = 0; i < N; ++i){
+        commits[i].randomize();
+    }
+
+    // every proof opens a commitment with its own serial, as coin spends do
+    std::vector<secp_primitives::Scalar> serials(indexes.size()), randomness(indexes.size());
+    for (std::size_t k = 0; k < indexes.size(); ++k) {
+        serials[k].randomize();
+        randomness[k].randomize();
+        commits[indexes[k]] = sigma::SigmaPrimitives<secp_primitives::Scalar,secp_primitives::GroupElement>::commit(
+            g, serials[k], h_gens[0], randomness[k]);
+    }
+
+    std::vector<sigma::SigmaPlusProof<secp_primitives::Scalar,secp_primitives::GroupElement>> proofs(
+        indexes.size(), sigma::SigmaPlusProof<secp_primitives::Scalar,secp_primitives::GroupElement>(n, m));
+    for (std::size_t k = 0; k < indexes.size(); ++k) {
+        secp_primitives::GroupElement gs = (g * serials[k]).inverse();
+        std::vector<secp_primitives::GroupElement> shifted;
+        for (const auto& c : commits)
+            shifted.push_back(c + gs);
+        prover.proof(shifted, indexes[k], randomness[k], true, proofs[k]);
+    }
+
+    sigma::SigmaPlusVerifier<secp_primitives::Scalar,secp_primitives::GroupElement> verifier(g, h_gens, n, m);
+    std::vector<const sigma::SigmaPlusProof<secp_primitives::Scalar,secp_primitives::GroupElement>*> proofPtrs;
+    for (const auto& proof : proofs)
+        proofPtrs.push_back(&proof);
+    std::vector<bool> fPadding(indexes.size(), true);
+
+    BOOST_CHECK(verifier.batch_verify(commits, serials, fPadding, proofPtrs));
+
+    // one wrong serial fails the whole batch, but not the proofs verified on their own
+    std::vector<secp_primitives::Scalar> wrongSerials(serials);
+    wrongSerials[1].randomize();
+    BOOST_CHECK(!verifier.batch_verify(commits, wrongSerials, fPadding, proofPtrs));
+    BOOST_CHECK(verifier.batch_verify(commits, {serials[0]}, {true}, {proofPtrs[0]}));
+    BOOST_CHECK(!verifier.batch_verify(commits, {wrongSerials[1]}, {true}, {proofPtrs[1]}));
+
+    // same results with the fixed-base tables of g and h
+    std::vector<secp_primitives::GroupElement> gens(1, g);
+    gens.insert(gens.end(), h_gens.begin(), h_gens.end());
+    secp_primitives::PrecomputedMultiExponent gensTable(gens);
+    sigma::SigmaPlusVerifier<secp_primitives::Scalar,secp_primitives::GroupElement> tableVerifier(g, h_gens, n, m, &gensTable);
+    BOOST_CHECK(tableVerifier.batch_verify(commits, serials, fPadding, proofPtrs));
+    BOOST_CHECK(!tableVerifier.batch_verify(commits, wrongSerials, fPadding, proofPtrs));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,97 @@
+// Copyright (c) 2020 The TecraCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "spendcache.h"
+
+#include "random.h"
+#include "serialize.h"
+#include "util.h"
+
+#include "cuckoocache.h"
+#include <boost/thread.hpp>
+
+namespace {
+
+/**
+ * Entries are salted hashes, their bytes can be used as the hashes of the cuckoo
+ * cache directly, as for the signature cache.
+ */
+class SpendCacheEntryHasher
+{
+public:
+    template <uint8_t hash_select>
+    uint32_t operator()(const uint256& key) const
+    {
+        static_assert(hash_select <8, "SpendCacheEntryHasher only has 8 hashes available.");
+        uint32_t u;
+        std::memcpy(&u, key.begin()+4*hash_select, 4);
+        return u;
+    }
+};
+
+class CSpendProofCache
+{
+private:
+    //! Entries are SHA256d(nonce || spend || verification context)
+    uint256 nonce;
+    typedef CuckooCache::cache<uint256, SpendCacheEntryHasher> map_type;
+    map_type setValid;
+    boost::shared_mutex cs_spendcache;
+
+public:
+    CSpendProofCache()
+    {
+        GetRandBytes(nonce.begin(), 32);
+    }
+
+    CHashWriter GetHasher() const
+    {
+        CHashWriter hasher(SER_GETHASH, 0);
+        hasher << nonce;
+        return hasher;
+    }
+
+    bool Get(const uint256& entry)
+    {
+        boost::shared_lock<boost::shared_mutex> lock(cs_spendcache);
+        return setValid.contains(entry, false);
+    }
+
+    void Set(uint256 entry)
+    {
+        boost::unique_lock<boost::shared_mutex> lock(cs_spendcache);
+        setValid.insert(entry);
+    }
+
+    uint32_t setup_bytes(size_t n)
+    {
+        return setValid.setup_bytes(n);
+    }
+};
+
+static CSpendProofCache spendProofCache;
+}
+
+CHashWriter SpendCacheHasher()
+{
+    return spendProofCache.GetHasher();
+}
+
+bool IsSpendProofCached(const uint256& entry)
+{
+    return spendProofCache.Get(entry);
+}
+
+void AddSpendProofToCache(const uint256& entry)
+{
+    spendProofCache.Set(entry);
+}
+
+void InitSpendProofCache()
+{
+    size_t nMaxCacheSize = std::min(std::max((int64_t)0, GetArg("-maxspendcachesize", DEFAULT_MAX_SPEND_CACHE_SIZE)), MAX_MAX_SPEND_CACHE_SIZE) * ((size_t) 1 << 20);
+    size_t nElems = spendProofCache.setup_bytes(nMaxCacheSize);
+    LogPrintf("Using %zu MiB out of %zu requested for spend proof cache, able to store %zu elements\n",
+            (nElems*sizeof(uint256)) >>20, nMaxCacheSize>>20, nElems);
+}
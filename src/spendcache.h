@@ -0,0 +1,35 @@
+// Copyright (c) 2020 The TecraCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef TECRACOIN_SPENDCACHE_H
+#define TECRACOIN_SPENDCACHE_H
+
+#include "hash.h"
+#include "uint256.h"
+
+// Limit the cache of verified spend proofs to 8MB (over 250000 entries)
+static const unsigned int DEFAULT_MAX_SPEND_CACHE_SIZE = 8;
+// Maximum spend cache size allowed
+static const int64_t MAX_MAX_SPEND_CACHE_SIZE = 16384;
+
+/**
+ * Cache of sigma and zerocoin spend proofs that passed verification, so that a
+ * spend accepted to the memory pool is not verified again when its block is
+ * connected. An entry is the hash of the spend together with everything its
+ * verification depends on, written to the hasher returned by SpendCacheHasher().
+ */
+
+// Hasher for a cache entry, seeded with the random nonce of the cache
+CHashWriter SpendCacheHasher();
+
+// Whether the spend of `entry` was verified before
+bool IsSpendProofCached(const uint256& entry);
+
+// Remember that the spend of `entry` passed verification
+void AddSpendProofToCache(const uint256& entry);
+
+// To be called once in AppInit2/TestingSetup to initialize the spend cache
+void InitSpendProofCache();
+
+#endif // TECRACOIN_SPENDCACHE_H
@@ -0,0 +1,241 @@
+// Copyright (c) 2020 The TecraCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "chain.h"
+#include "chainparams.h"
+#include "clientversion.h"
+#include "streams.h"
+#include "txdb.h"
+#include "zerocoin_params.h"
+
+#include "test/test_bitcoin.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <map>
+#include <memory>
+
+BOOST_FIXTURE_TEST_SUITE(blockprivacydata_tests, TestingSetup)
+
+namespace {
+
+// key prefix of block index entries in the block tree database
+const char DB_BLOCK_INDEX = 'b';
+
+CBlockPrivacyData MakePrivacyData(int seed)
+{
+    CBlockPrivacyData data;
+    data.mintedPubCoins[std::make_pair(1, 1)].push_back(CBigNum(seed));
+    data.mintedPubCoins[std::make_pair(10, 2)].push_back(CBigNum(seed + 1));
+    data.accumulatorChanges[std::make_pair(1, 1)] = std::make_pair(CBigNum(seed + 2), 1);
+    data.spentSerials.insert(CBigNum(seed + 3));
+    return data;
+}
+
+void CheckEqual(const CBlockPrivacyData& data1, const CBlockPrivacyData& data2)
+{
+    BOOST_CHECK(data1.mintedPubCoins == data2.mintedPubCoins);
+    BOOST_CHECK(data1.accumulatorChanges == data2.accumulatorChanges);
+    BOOST_CHECK(data1.spentSerials == data2.spentSerials);
+}
+
+// Block index entry that passes the proof of work check of LoadBlockIndexGuts
+void InitBlockIndex(CBlockIndex& index, const uint256& hash)
+{
+    index.phashBlock = &hash;
+    index.nHeight = 1;
+    index.nBits = UintToArith256(Params().GetConsensus().powLimit).GetCompact();
+}
+
+// Writes pre-serialized bytes as a database value
+struct RawValue
+{
+    const CDataStream& ss;
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        s.write(&ss[0], ss.size());
+    }
+};
+
+struct BlockIndexMap
+{
+    std::map<uint256, std::unique_ptr<CBlockIndex>> indexes;
+
+    CBlockIndex* Insert(const uint256& hash)
+    {
+        if (hash.IsNull())
+            return nullptr;
+        auto it = indexes.find(hash);
+        if (it == indexes.end()) {
+            it = indexes.emplace(hash, std::unique_ptr<CBlockIndex>(new CBlockIndex())).first;
+            it->second->phashBlock = &it->first;
+        }
+        return it->second.get();
+    }
+};
+
+const uint256 hashA = ArithToUint256(arith_uint256(1));
+const uint256 hashB = ArithToUint256(arith_uint256(2));
+
+bool ReadTestPrivacyData(const uint256& hash, CBlockPrivacyData& data)
+{
+    if (hash != hashA)
+        return false;
+    data = MakePrivacyData(100);
+    return true;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(privacy_index_roundtrip)
+{
+    CBlockTreeDB db(1 << 20, true);
+
+    CBlockIndex index;
+    InitBlockIndex(index, hashA);
+    index.GetPrivacyDataForUpdate() = MakePrivacyData(100);
+    BOOST_CHECK(db.WriteBatchSync({}, 0, {&index}));
+
+    CBlockPrivacyData data;
+    BOOST_CHECK(db.ReadPrivacyData(hashA, data));
+    CheckEqual(data, MakePrivacyData(100));
+
+    // the block index entry itself only records that there is data
+    CDiskBlockIndex diskindex;
+    BOOST_CHECK(db.Read(std::make_pair(DB_BLOCK_INDEX, hashA), diskindex));
+    BOOST_CHECK(diskindex.nStatus & BLOCK_HAVE_PRIVACY_DATA);
+    BOOST_CHECK(!diskindex.legacyPrivacyData);
+
+    // removing the data removes the entry
+    index.GetPrivacyDataForUpdate() = CBlockPrivacyData();
+    BOOST_CHECK(db.WriteBatchSync({}, 0, {&index}));
+    BOOST_CHECK(!db.ReadPrivacyData(hashA, data));
+    BOOST_CHECK(db.Read(std::make_pair(DB_BLOCK_INDEX, hashA), diskindex));
+    BOOST_CHECK(!(diskindex.nStatus & BLOCK_HAVE_PRIVACY_DATA));
+}
+
+BOOST_AUTO_TEST_CASE(privacy_index_rejected_by_older_versions)
+{
+    CBlockTreeDB db(1 << 20, true);
+
+    CBlockIndex index;
+    InitBlockIndex(index, hashA);
+    BOOST_CHECK(db.WriteBatchSync({}, 0, {&index}));
+
+    // Older versions take the version of the block index from the first entry and force a reindex if it
+    // can't be read or is too old. The marker is the first entry
+    CDiskBlockIndex marker;
+    if (db.Read(std::make_pair(DB_BLOCK_INDEX, uint256()), marker))
+        BOOST_CHECK(marker.nDiskBlockVersion < ZC_ADVANCED_INDEX_VERSION);
+    BOOST_CHECK(db.Exists(std::make_pair(DB_BLOCK_INDEX, uint256())));
+
+    // this version skips it
+    BOOST_CHECK_EQUAL(db.GetBlockIndexVersion(), CLIENT_VERSION);
+    BlockIndexMap indexes;
+    BOOST_CHECK(db.LoadBlockIndexGuts(std::bind(&BlockIndexMap::Insert, &indexes, std::placeholders::_1)));
+    BOOST_CHECK_EQUAL(indexes.indexes.size(), 1);
+    BOOST_CHECK(indexes.indexes.count(hashA));
+}
+
+BOOST_AUTO_TEST_CASE(privacy_index_legacy_migration)
+{
+    CBlockTreeDB db(1 << 20, true);
+
+    // block B is written by this version, its data is in the privacy index
+    CBlockIndex indexB;
+    InitBlockIndex(indexB, hashB);
+    indexB.GetPrivacyDataForUpdate() = MakePrivacyData(200);
+    BOOST_CHECK(db.WriteBatchSync({}, 0, {&indexB}));
+
+    // block A is written by an older version with the data inline. The entry ends with the three zerocoin
+    // maps, which are written empty now (the block is below the sigma start block)
+    CBlockIndex indexA;
+    InitBlockIndex(indexA, hashA);
+    BOOST_REQUIRE(indexA.nHeight < Params().GetConsensus().nSigmaStartBlock);
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss << CDiskBlockIndex(&indexA);
+    ss.resize(ss.size() - 3);
+    CBlockPrivacyData legacyData = MakePrivacyData(100);
+    ss << legacyData.mintedPubCoins << legacyData.accumulatorChanges << legacyData.spentSerials;
+    BOOST_CHECK(db.Write(std::make_pair(DB_BLOCK_INDEX, hashA), RawValue{ss}));
+
+    BlockIndexMap indexes;
+    BOOST_CHECK(db.LoadBlockIndexGuts(std::bind(&BlockIndexMap::Insert, &indexes, std::placeholders::_1)));
+    BOOST_REQUIRE(indexes.indexes.count(hashA) && indexes.indexes.count(hashB));
+
+    // the status bit is only used on disk
+    const CBlockIndex* pindexA = indexes.indexes[hashA].get();
+    const CBlockIndex* pindexB = indexes.indexes[hashB].get();
+    BOOST_CHECK(!(pindexA->nStatus & BLOCK_HAVE_PRIVACY_DATA));
+    BOOST_CHECK(!(pindexB->nStatus & BLOCK_HAVE_PRIVACY_DATA));
+
+    // inline data is loaded right away, the other is left on disk
+    BOOST_CHECK(pindexA->HasPrivacyData());
+    BOOST_CHECK(pindexA->IsPrivacyDataLoaded());
+    CheckEqual(pindexA->GetPrivacyData(), legacyData);
+    BOOST_CHECK(pindexB->HasPrivacyData());
+    BOOST_CHECK(!pindexB->IsPrivacyDataLoaded());
+
+    // the inline data of A was moved to the privacy index
+    CBlockPrivacyData data;
+    BOOST_CHECK(db.ReadPrivacyData(hashA, data));
+    CheckEqual(data, legacyData);
+    CDiskBlockIndex diskindex;
+    BOOST_CHECK(db.Read(std::make_pair(DB_BLOCK_INDEX, hashA), diskindex));
+    BOOST_CHECK(diskindex.nStatus & BLOCK_HAVE_PRIVACY_DATA);
+    BOOST_CHECK(!diskindex.legacyPrivacyData);
+
+    // and is left on disk on the next load
+    BlockIndexMap indexes2;
+    BOOST_CHECK(db.LoadBlockIndexGuts(std::bind(&BlockIndexMap::Insert, &indexes2, std::placeholders::_1)));
+    BOOST_CHECK(indexes2.indexes[hashA]->HasPrivacyData());
+    BOOST_CHECK(!indexes2.indexes[hashA]->IsPrivacyDataLoaded());
+}
+
+BOOST_AUTO_TEST_CASE(privacy_data_lazy_loading)
+{
+    bool (*savedReadBlockPrivacyData)(const uint256&, CBlockPrivacyData&) = ReadBlockPrivacyData;
+    ReadBlockPrivacyData = ReadTestPrivacyData;
+
+    CBlockIndex index;
+    InitBlockIndex(index, hashA);
+    index.SetPrivacyDataOnDisk();
+    BOOST_CHECK(index.HasPrivacyData());
+    BOOST_CHECK(!index.IsPrivacyDataLoaded());
+    CheckEqual(index.GetPrivacyData(), MakePrivacyData(100));
+    BOOST_CHECK(index.IsPrivacyDataLoaded());
+
+    // data which can't be read is an error, not an empty block
+    CBlockIndex missing;
+    InitBlockIndex(missing, hashB);
+    missing.SetPrivacyDataOnDisk();
+    BOOST_CHECK_THROW(missing.GetPrivacyData(), std::runtime_error);
+    BOOST_CHECK_THROW(missing.GetPrivacyDataForUpdate(), std::runtime_error);
+
+    ReadBlockPrivacyData = savedReadBlockPrivacyData;
+}
+
+BOOST_AUTO_TEST_CASE(privacy_data_copy_on_write)
+{
+    CBlockIndex index;
+    InitBlockIndex(index, hashA);
+    index.GetPrivacyDataForUpdate() = MakePrivacyData(100);
+
+    // copies share the data until it is changed
+    CBlockIndex copy(index);
+    BOOST_CHECK(&copy.GetPrivacyData() == &index.GetPrivacyData());
+    copy.GetPrivacyDataForUpdate().spentSerials.insert(CBigNum(1000));
+    BOOST_CHECK_EQUAL(copy.GetPrivacyData().spentSerials.size(), 2);
+    BOOST_CHECK_EQUAL(index.GetPrivacyData().spentSerials.size(), 1);
+
+    // an entry being written keeps the data it was created with
+    CDiskBlockIndex diskindex(&index);
+    index.GetPrivacyDataForUpdate().spentSerials.clear();
+    BOOST_CHECK_EQUAL(diskindex.GetPrivacyData().spentSerials.size(), 1);
+    BOOST_CHECK(index.GetPrivacyData().spentSerials.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
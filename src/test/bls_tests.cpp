@@ -46,6 +46,35 @@ BOOST_AUTO_TEST_CASE(bls_sig_tests)
     BOOST_CHECK(sig2.VerifyInsecure(sk2.GetPublicKey(), msgHash1));
 }
 
+BOOST_AUTO_TEST_CASE(bls_aggregate_secure_tests)
+{
+    uint256 msgHash = uint256S("0000000000000000000000000000000000000000000000000000000000000001");
+
+    std::vector<CBLSPublicKey> pks;
+    std::vector<CBLSSignature> sigs;
+    for (int i = 0; i < 5; i++) {
+        CBLSSecretKey sk;
+        sk.MakeNewKey();
+        pks.emplace_back(sk.GetPublicKey());
+        sigs.emplace_back(sk.Sign(msgHash));
+    }
+
+    auto aggSig = CBLSSignature::AggregateSecure(sigs, pks, msgHash);
+    BOOST_CHECK(aggSig.VerifySecureAggregated(pks, msgHash));
+
+    // a securely aggregated signature verifies against the securely aggregated public key
+    auto aggPk = CBLSPublicKey::AggregateSecure(pks);
+    BOOST_CHECK(aggPk.IsValid());
+    BOOST_CHECK(aggSig.VerifyInsecure(aggPk, msgHash));
+    BOOST_CHECK(aggPk != CBLSPublicKey::AggregateInsecure(pks));
+
+    // but not against the key of a different set of signers
+    std::vector<CBLSPublicKey> otherPks(pks.begin(), pks.end() - 1);
+    BOOST_CHECK(!aggSig.VerifyInsecure(CBLSPublicKey::AggregateSecure(otherPks), msgHash));
+
+    BOOST_CHECK(!CBLSPublicKey::AggregateSecure({}).IsValid());
+}
+
 struct Message
 {
     uint32_t sourceId;
@@ -17,6 +17,12 @@
 #include "evo/specialtx.h"
 #include "evo/providertx.h"
 #include "evo/deterministicmns.h"
+#include "evo/simplifiedmns.h"
+#include "llmq/quorums_commitment.h"
+
+#include "consensus/validation.h"
+#include "merkleblock.h"
+#include "streams.h"
 
 #include <boost/test/unit_test.hpp>
 
@@ -218,6 +224,34 @@ static CDeterministicMNCPtr FindPayoutDmn(const CBlock& block)
     return nullptr;
 }
 
+// Builds the diff from scratch, bypassing the cache in BuildSimplifiedMNListDiff
+static CSimplifiedMNListDiff BuildUncachedSimplifiedMNListDiff(const uint256& baseBlockHash, const CBlockIndex* baseBlockIndex, const CBlockIndex* blockIndex)
+{
+    auto diff = deterministicMNManager->GetListForBlock(baseBlockIndex).BuildSimplifiedDiff(deterministicMNManager->GetListForBlock(blockIndex));
+    diff.baseBlockHash = baseBlockHash;
+    BOOST_CHECK(diff.BuildQuorumsDiff(baseBlockIndex, blockIndex));
+
+    CBlock block;
+    BOOST_CHECK(ReadBlockFromDisk(block, blockIndex, Params().GetConsensus()));
+    std::vector<uint256> vHashes;
+    std::vector<bool> vMatch(block.vtx.size(), false);
+    for (const auto& tx : block.vtx) {
+        vHashes.emplace_back(tx->GetHash());
+    }
+    vMatch[0] = true;
+    diff.cbTx = block.vtx[0];
+    diff.cbTxMerkleTree = CPartialMerkleTree(vHashes, vMatch);
+    return diff;
+}
+
+template<typename T>
+static std::string SerializeToString(const T& obj)
+{
+    CDataStream ds(SER_NETWORK, PROTOCOL_VERSION);
+    ds << obj;
+    return ds.str();
+}
+
 BOOST_AUTO_TEST_SUITE(evo_dip3_activation_tests)
 
 BOOST_FIXTURE_TEST_CASE(dip3_activation, TestChainDIP3BeforeActivationSetup)
@@ -417,4 +451,127 @@ BOOST_FIXTURE_TEST_CASE(dip3_protx, TestChainDIP3Setup)
 
     const_cast<Consensus::Params&>(Params().GetConsensus()).DIP0003EnforcementHeight = DIP0003EnforcementHeightBackup;
 }
+
+BOOST_FIXTURE_TEST_CASE(dip3_mnlistdiff_cache, TestChainDIP3Setup)
+{
+    auto utxos = BuildSimpleUtxoMap(coinbaseTxns);
+
+    std::vector<uint256> dmnHashes;
+    std::map<uint256, CBLSSecretKey> operatorKeys;
+
+    for (int i = 0; i < 3; i++) {
+        CKey ownerKey;
+        CBLSSecretKey operatorKey;
+        auto tx = CreateProRegTx(utxos, i + 1, GenerateRandomAddress(), coinbaseKey, ownerKey, operatorKey);
+        dmnHashes.emplace_back(tx.GetHash());
+        operatorKeys.emplace(tx.GetHash(), operatorKey);
+        CreateAndProcessBlock({tx}, coinbaseKey);
+        deterministicMNManager->UpdatedBlockTip(chainActive.Tip());
+    }
+    const CBlockIndex* pindexBase = chainActive.Tip();
+
+    auto tx = CreateProUpServTx(utxos, dmnHashes[0], operatorKeys[dmnHashes[0]], 100, CScript(), coinbaseKey);
+    CreateAndProcessBlock({tx}, coinbaseKey);
+    deterministicMNManager->UpdatedBlockTip(chainActive.Tip());
+
+    LOCK(cs_main);
+    CBlockIndex* pindex = chainActive.Tip();
+    uint256 blockHash = pindex->GetBlockHash();
+
+    for (const uint256& baseBlockHash : {uint256(), pindexBase->GetBlockHash()}) {
+        const CBlockIndex* baseBlockIndex = baseBlockHash.IsNull() ? chainActive.Genesis() : pindexBase;
+        auto expected = BuildUncachedSimplifiedMNListDiff(baseBlockHash, baseBlockIndex, pindex);
+        BOOST_CHECK_EQUAL(expected.mnList.size(), baseBlockHash.IsNull() ? 3 : 1);
+
+        // first call builds the diff and caches it, second one is served from the cache
+        for (int i = 0; i < 2; i++) {
+            CSimplifiedMNListDiff diff;
+            std::string strError;
+            BOOST_CHECK(BuildSimplifiedMNListDiff(baseBlockHash, blockHash, diff, strError));
+            BOOST_CHECK(SerializeToString(diff) == SerializeToString(expected));
+        }
+    }
+
+    // a diff for a disconnected block must be rejected instead of being served from the cache
+    CValidationState state;
+    BOOST_CHECK(InvalidateBlock(state, Params(), pindex));
+    BOOST_CHECK(!chainActive.Contains(pindex));
+    deterministicMNManager->UpdatedBlockTip(chainActive.Tip());
+
+    for (const uint256& baseBlockHash : {uint256(), pindexBase->GetBlockHash()}) {
+        CSimplifiedMNListDiff diff;
+        std::string strError;
+        BOOST_CHECK(!BuildSimplifiedMNListDiff(baseBlockHash, blockHash, diff, strError));
+    }
+
+    // the new tip is still served
+    CSimplifiedMNListDiff diff;
+    std::string strError;
+    BOOST_CHECK(BuildSimplifiedMNListDiff(uint256(), chainActive.Tip()->GetBlockHash(), diff, strError));
+    BOOST_CHECK(SerializeToString(diff) == SerializeToString(BuildUncachedSimplifiedMNListDiff(uint256(), chainActive.Genesis(), chainActive.Tip())));
+}
+
+BOOST_FIXTURE_TEST_CASE(dip3_historic_lists_cache, TestChainDIP3Setup)
+{
+    auto utxos = BuildSimpleUtxoMap(coinbaseTxns);
+
+    std::vector<uint256> dmnHashes;
+    std::map<uint256, CBLSSecretKey> operatorKeys;
+    int port = 1;
+
+    // mine past the recent lists window, registering and updating MNs on the way
+    int nStartHeight = chainActive.Height();
+    const int nBlocks = CDeterministicMNManager::LISTS_CACHE_SIZE + 8 * CDeterministicMNManager::HISTORIC_LISTS_CACHE_INTERVAL;
+    for (int i = 0; i < nBlocks; i++) {
+        std::vector<CMutableTransaction> txns;
+        if (i % 50 == 0) {
+            CKey ownerKey;
+            CBLSSecretKey operatorKey;
+            auto tx = CreateProRegTx(utxos, port++, GenerateRandomAddress(), coinbaseKey, ownerKey, operatorKey);
+            dmnHashes.emplace_back(tx.GetHash());
+            operatorKeys.emplace(tx.GetHash(), operatorKey);
+            txns.emplace_back(tx);
+        } else if (i % 50 == 25) {
+            const uint256& proTxHash = dmnHashes.back();
+            txns.emplace_back(CreateProUpServTx(utxos, proTxHash, operatorKeys[proTxHash], port++, CScript(), coinbaseKey));
+        }
+        CreateAndProcessBlock(txns, coinbaseKey);
+        deterministicMNManager->UpdatedBlockTip(chainActive.Tip());
+    }
+
+    LOCK(cs_main);
+    BOOST_CHECK_EQUAL(chainActive.Height(), nStartHeight + nBlocks);
+    int nOldestRecentHeight = chainActive.Height() - CDeterministicMNManager::LISTS_CACHE_SIZE;
+
+    // lists for old blocks, on and off the historic interval, must match the ones rebuilt from disk. Query each
+    // twice so that the second query is served from whatever has been cached by the first one
+    CDeterministicMNManager freshManager(*evoDb);
+    for (int nHeight = nStartHeight + 1; nHeight < nOldestRecentHeight; nHeight++) {
+        const CBlockIndex* pindex = chainActive[nHeight];
+        auto expected = freshManager.GetListForBlock(pindex);
+        BOOST_CHECK_EQUAL(expected.GetHeight(), nHeight);
+        BOOST_CHECK(expected.GetBlockHash() == pindex->GetBlockHash());
+        for (int i = 0; i < 2; i++) {
+            auto mnList = deterministicMNManager->GetListForBlock(pindex);
+            BOOST_CHECK_EQUAL(mnList.GetHeight(), nHeight);
+            BOOST_CHECK(mnList.GetBlockHash() == pindex->GetBlockHash());
+            BOOST_CHECK(SerializeToString(mnList) == SerializeToString(expected));
+        }
+    }
+
+    // an undone block must not be returned from the historic cache anymore
+    int nUndoHeight = nOldestRecentHeight - 1;
+    nUndoHeight -= nUndoHeight % CDeterministicMNManager::HISTORIC_LISTS_CACHE_INTERVAL;
+    BOOST_ASSERT(nUndoHeight > nStartHeight);
+    const CBlockIndex* pindexUndo = chainActive[nUndoHeight];
+    BOOST_CHECK(deterministicMNManager->GetListForBlock(pindexUndo).GetAllMNsCount() != 0);
+
+    CBlock block;
+    BOOST_CHECK(ReadBlockFromDisk(block, pindexUndo, Params().GetConsensus()));
+    BOOST_CHECK(deterministicMNManager->UndoBlock(block, pindexUndo));
+
+    auto mnList = deterministicMNManager->GetListForBlock(pindexUndo);
+    BOOST_CHECK_EQUAL(mnList.GetHeight(), -1);
+    BOOST_CHECK_EQUAL(mnList.GetAllMNsCount(), 0);
+}
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,63 @@
+// Copyright (c) 2020 The TecraCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "llmq/quorums_dkgsession.h"
+#include "llmq/quorums_dkgsessionmgr.h"
+
+#include "arith_uint256.h"
+#include "chainparams.h"
+#include "dbwrapper.h"
+#include "util.h"
+
+#include "test/test_bitcoin.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace llmq;
+
+BOOST_FIXTURE_TEST_SUITE(llmq_dkgsession_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(dkgsession_destroy_after_worker_stop)
+{
+    const Consensus::LLMQParams& params = Params().GetConsensus().llmqs.begin()->second;
+
+    CBLSWorker worker;
+    worker.Start(1);
+
+    BLSIdVector ids;
+    for (int i = 0; i < 2; i++) {
+        ids.emplace_back(CBLSId::FromHash(ArithToUint256(arith_uint256(i + 1))));
+    }
+    BLSVerificationVectorPtr vvec;
+    BLSSecretKeyVector skShares;
+    bool fGenerated = worker.GenerateContributions(2, ids, vvec, skShares);
+    BOOST_REQUIRE(fGenerated);
+
+    // a verification on a running worker finishes
+    std::vector<BLSVerificationVectorPtr> vvecs{vvec};
+    BLSSecretKeyVector skContributions{skShares[0]};
+    auto f = worker.AsyncVerifyContributionShares(ids[0], vvecs, skContributions, true, true);
+    BOOST_CHECK(worker.WaitForResult(f));
+    BOOST_CHECK(f.get() == std::vector<bool>{true});
+
+    worker.Stop();
+
+    CDBWrapper db(GetDataDir() / "llmq", 1 << 20, true);
+    CDKGSessionManager dkgManager(db, worker);
+    std::unique_ptr<CDKGSession> session(new CDKGSession(params, worker, dkgManager));
+
+    std::unique_ptr<CDKGSession::RunningContributionVerification> v(new CDKGSession::RunningContributionVerification());
+    v->memberIndexes.emplace_back(0);
+    v->vvecs.emplace_back(vvec);
+    v->skContributions.emplace_back(skShares[0]);
+    // the stopped worker never runs this, so the result never gets ready
+    v->result = worker.AsyncVerifyContributionShares(ids[0], v->vvecs, v->skContributions, true, true);
+    BOOST_CHECK(!worker.WaitForResult(v->result));
+    session->runningContributionVerifications.emplace_back(std::move(v));
+
+    // must return instead of waiting for the dropped verification
+    session.reset();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
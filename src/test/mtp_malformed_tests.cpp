@@ -71,9 +71,8 @@ BOOST_AUTO_TEST_CASE(mtp_malformed)
     memset(bMtp.mtpHashData->hashRootMTP, 0, sizeof(bMtp.mtpHashData->hashRootMTP));
     memset(bMtp.mtpHashData->nBlockMTP, 0, sizeof(bMtp.mtpHashData->nBlockMTP));
     for(unsigned int i = 0; i < 48; i++)
-        for(unsigned int j = 0; j < bMtp.mtpHashData->nProofMTP[i].size(); j++)
-            for(unsigned int k = 0; k < bMtp.mtpHashData->nProofMTP[i][j].size(); k++)
-                bMtp.mtpHashData->nProofMTP[i][j][k] = 0;
+        memset(bMtp.mtpHashData->nProofMTP.GetProof(i), 0,
+            bMtp.mtpHashData->nProofMTP.GetProofSize(i) * mtp::ProofSet::NODE_SIZE);
     ProcessBlock(bMtp);
     BOOST_CHECK_MESSAGE(previousHeight == chainActive.Height(), "Block connected with incorrect proof");
 
@@ -85,9 +84,8 @@ BOOST_AUTO_TEST_CASE(mtp_malformed)
 
     bMtp = CreateBlock(scriptPubKey, mtp);
     for(unsigned int i = 0; i < 48; i++)
-        for(unsigned int j = 0; j < bMtp.mtpHashData->nProofMTP[i].size(); j++)
-            for(unsigned int k = 0; k < bMtp.mtpHashData->nProofMTP[i][j].size(); k++)
-                bMtp.mtpHashData->nProofMTP[i][j][k] = 0;
+        memset(bMtp.mtpHashData->nProofMTP.GetProof(i), 0,
+            bMtp.mtpHashData->nProofMTP.GetProofSize(i) * mtp::ProofSet::NODE_SIZE);
     ProcessBlock(bMtp);
     BOOST_CHECK_MESSAGE(previousHeight == chainActive.Height(), "Block connected with missing proof");
 
@@ -99,17 +97,15 @@ BOOST_AUTO_TEST_CASE(mtp_malformed)
         for(unsigned int j = 0; j < 128; j++)
         bMtp.mtpHashData->nBlockMTP[i][j] = rand();
     for(unsigned int i = 0; i < 48; i++)
-        for(unsigned int j = 0; j < bMtp.mtpHashData->nProofMTP[i].size(); j++)
-            for(unsigned int k = 0; k < bMtp.mtpHashData->nProofMTP[i][j].size(); k++)
-                bMtp.mtpHashData->nProofMTP[i][j][k] = rand()%256;
+        for(unsigned int k = 0; k < bMtp.mtpHashData->nProofMTP.GetProofSize(i) * mtp::ProofSet::NODE_SIZE; k++)
+            bMtp.mtpHashData->nProofMTP.GetProof(i)[k] = rand()%256;
     ProcessBlock(bMtp);
     BOOST_CHECK_MESSAGE(previousHeight == chainActive.Height(), "Block connected with incorrect proof");
 
     bMtp = CreateBlock(scriptPubKey, mtp);
     previousHeight = chainActive.Height();
     for(unsigned int i = 0; i < 48; i++)
-        for(unsigned int j = 0; j < bMtp.mtpHashData->nProofMTP[i].size(); j++)
-            bMtp.mtpHashData->nProofMTP[i][j].resize(bMtp.mtpHashData->nProofMTP[i][j].size()/2);
+        bMtp.mtpHashData->nProofMTP.TruncateProof(i, bMtp.mtpHashData->nProofMTP.GetProofSize(i)/2);
     ProcessBlock(bMtp);
     BOOST_CHECK_MESSAGE(previousHeight == chainActive.Height(), "Block connected with incorrect proof");
 
@@ -123,10 +119,10 @@ BOOST_AUTO_TEST_CASE(mtp_malformed)
     BOOST_CHECK_MESSAGE(memcmp(outh.nBlockMTP, bMtp.mtpHashData->nBlockMTP, sizeof(outh.nBlockMTP))
         == 0, "Serialize does not match unserialize");
     for(unsigned int i = 0; i < 48; i++)
-        for(unsigned int j = 0; j < bMtp.mtpHashData->nProofMTP[i].size(); j++)
-            for(unsigned int k = 0; k < bMtp.mtpHashData->nProofMTP[i][j].size(); k++)
-                BOOST_CHECK_MESSAGE(outh.nProofMTP[i][j][k] == bMtp.mtpHashData->nProofMTP[i][j][k],
-                     "Serialize does not match unserialize");
+        BOOST_CHECK_MESSAGE(outh.nProofMTP.GetProofSize(i) == bMtp.mtpHashData->nProofMTP.GetProofSize(i),
+             "Serialize does not match unserialize");
+    BOOST_CHECK_MESSAGE(outh.nProofMTP.GetNodes() == bMtp.mtpHashData->nProofMTP.GetNodes(),
+         "Serialize does not match unserialize");
 
     mybufstream.clear();
     mybufstream << *bMtp.mtpHashData;
@@ -40,7 +40,7 @@ BOOST_AUTO_TEST_CASE(mtp_impl_integrity_test)
     uint8_t hash_root_mtp[16];
     unsigned int nonce;
     uint64_t block_mtp[mtp::MTP_L*2][128];
-    std::deque<std::vector<uint8_t>> proof_mtp[mtp::MTP_L*3];
+    mtp::ProofSet proof_mtp;
     uint256 output;
 
     mtp::impl::mtp_hash(input, target, hash_root_mtp, nonce, block_mtp, proof_mtp,
@@ -50,6 +50,12 @@ BOOST_AUTO_TEST_CASE(mtp_impl_integrity_test)
     bool ok = mtp::impl::mtp_verify(input, target, hash_root_mtp, nonce, block_mtp,
             proof_mtp, pow_limit);
     BOOST_CHECK_MESSAGE(ok, "mtp_verify() failed");
+
+    BOOST_CHECK(proof_mtp.GetProofCount() == mtp::ProofSet::PROOF_COUNT);
+    proof_mtp.TruncateProof(0, proof_mtp.GetProofSize(0) - 1);
+    ok = mtp::impl::mtp_verify(input, target, hash_root_mtp, nonce, block_mtp,
+            proof_mtp, pow_limit);
+    BOOST_CHECK_MESSAGE(!ok, "mtp_verify() accepted a truncated proof");
 }
 
 
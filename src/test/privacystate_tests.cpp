@@ -0,0 +1,167 @@
+// Copyright (c) 2020 The TecraCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "clientversion.h"
+#include "hash.h"
+#include "sigma.h"
+#include "sigma/coin.h"
+#include "streams.h"
+#include "util.h"
+#include "validation.h"
+#include "zerocoin.h"
+
+#include "test/test_bitcoin.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+BOOST_FIXTURE_TEST_SUITE(privacystate_tests, TestingSetup)
+
+namespace {
+
+struct PrivacyStateFile
+{
+    uint64_t version;
+    std::vector<char> data;
+    uint256 hash;
+
+    void Read()
+    {
+        CAutoFile file(fopen((GetDataDir() / "privacystate.dat").string().c_str(), "rb"), SER_DISK, CLIENT_VERSION);
+        BOOST_REQUIRE(!file.IsNull());
+        file >> version >> data >> hash;
+    }
+
+    void Write() const
+    {
+        CAutoFile file(fopen((GetDataDir() / "privacystate.dat").string().c_str(), "wb"), SER_DISK, CLIENT_VERSION);
+        BOOST_REQUIRE(!file.IsNull());
+        file << version << data << hash;
+    }
+};
+
+// Puts a zerocoin and a sigma serial into the states and dumps them at the chain tip
+void DumpTestState(const CBigNum& zcSerial, const Scalar& sigmaSerial)
+{
+    CZerocoinState::GetZerocoinState()->Reset();
+    sigma::CSigmaState::GetState()->Reset();
+    CZerocoinState::GetZerocoinState()->AddSpend(zcSerial);
+    sigma::CSigmaState::GetState()->AddSpend(sigmaSerial, sigma::CoinDenomination::SIGMA_DENOM_1, 1);
+    DumpPrivacyState();
+    CZerocoinState::GetZerocoinState()->Reset();
+    sigma::CSigmaState::GetState()->Reset();
+}
+
+bool IsStateLoaded(const CBigNum& zcSerial, const Scalar& sigmaSerial)
+{
+    return CZerocoinState::GetZerocoinState()->IsUsedCoinSerial(zcSerial) &&
+        sigma::CSigmaState::GetState()->IsUsedCoinSerial(sigmaSerial);
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(privacy_state_roundtrip)
+{
+    LOCK(cs_main);
+    CBigNum zcSerial(1000);
+    Scalar sigmaSerial;
+    sigmaSerial.randomize();
+
+    // nothing is loaded without a file
+    BOOST_CHECK(LoadPrivacyState() == NULL);
+
+    DumpTestState(zcSerial, sigmaSerial);
+    BOOST_CHECK(!IsStateLoaded(zcSerial, sigmaSerial));
+    BOOST_CHECK(LoadPrivacyState() == chainActive.Tip());
+    BOOST_CHECK(IsStateLoaded(zcSerial, sigmaSerial));
+
+    CZerocoinState::GetZerocoinState()->Reset();
+    sigma::CSigmaState::GetState()->Reset();
+}
+
+BOOST_AUTO_TEST_CASE(privacy_state_checksum_mismatch)
+{
+    LOCK(cs_main);
+    CBigNum zcSerial(1000);
+    Scalar sigmaSerial;
+    sigmaSerial.randomize();
+
+    DumpTestState(zcSerial, sigmaSerial);
+    PrivacyStateFile file;
+    file.Read();
+    BOOST_REQUIRE(!file.data.empty());
+    file.data.back() ^= 1;
+    file.Write();
+
+    BOOST_CHECK(LoadPrivacyState() == NULL);
+    BOOST_CHECK(!CZerocoinState::GetZerocoinState()->IsUsedCoinSerial(zcSerial));
+    BOOST_CHECK(!sigma::CSigmaState::GetState()->IsUsedCoinSerial(sigmaSerial));
+}
+
+BOOST_AUTO_TEST_CASE(privacy_state_version_mismatch)
+{
+    LOCK(cs_main);
+    CBigNum zcSerial(1000);
+    Scalar sigmaSerial;
+    sigmaSerial.randomize();
+
+    DumpTestState(zcSerial, sigmaSerial);
+    PrivacyStateFile file;
+    file.Read();
+    file.version++;
+    file.Write();
+
+    BOOST_CHECK(LoadPrivacyState() == NULL);
+    BOOST_CHECK(!CZerocoinState::GetZerocoinState()->IsUsedCoinSerial(zcSerial));
+    BOOST_CHECK(!sigma::CSigmaState::GetState()->IsUsedCoinSerial(sigmaSerial));
+}
+
+BOOST_AUTO_TEST_CASE(privacy_state_not_on_active_chain)
+{
+    LOCK(cs_main);
+    CBigNum zcSerial(1000);
+    Scalar sigmaSerial;
+    sigmaSerial.randomize();
+
+    // a sigma coin group in a block which is known but not part of the active chain
+    uint256 hash = uint256S("f1");
+    CBlockIndex index;
+    index.nHeight = 1;
+    index.pprev = chainActive.Tip();
+    index.phashBlock = &hash;
+    mapBlockIndex[hash] = &index;
+
+    CBlock block;
+    block.sigmaTxInfo = std::make_shared<sigma::CSigmaTxInfo>();
+    block.sigmaTxInfo->mints.push_back(
+        sigma::PrivateCoin(sigma::Params::get_default(), sigma::CoinDenomination::SIGMA_DENOM_1).getPublicCoin());
+    sigma::CSigmaState::GetState()->Reset();
+    sigma::CSigmaState::GetState()->AddMintsToStateAndBlockIndex(&index, &block);
+    CZerocoinState::GetZerocoinState()->Reset();
+    CZerocoinState::GetZerocoinState()->AddSpend(zcSerial);
+    DumpPrivacyState();
+    CZerocoinState::GetZerocoinState()->Reset();
+    sigma::CSigmaState::GetState()->Reset();
+
+    // the zerocoin state is read before the sigma state is rejected, nothing of it may be left
+    BOOST_CHECK(LoadPrivacyState() == NULL);
+    BOOST_CHECK(!CZerocoinState::GetZerocoinState()->IsUsedCoinSerial(zcSerial));
+    BOOST_CHECK_EQUAL(sigma::CSigmaState::GetState()->GetLatestCoinID(sigma::CoinDenomination::SIGMA_DENOM_1), 0);
+
+    // as is a snapshot taken at a block which isn't known
+    DumpTestState(zcSerial, sigmaSerial);
+    PrivacyStateFile file;
+    file.Read();
+    BOOST_REQUIRE(file.data.size() > 32);
+    file.data[0] ^= 1;
+    file.hash = Hash(file.data.begin(), file.data.end());
+    file.Write();
+    BOOST_CHECK(LoadPrivacyState() == NULL);
+    BOOST_CHECK(!IsStateLoaded(zcSerial, sigmaSerial));
+
+    mapBlockIndex.erase(hash);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,60 @@
+// Copyright (c) 2020 The TecraCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "sharded_lru_cache.h"
+#include "arith_uint256.h"
+#include "saltedhasher.h"
+#include "uint256.h"
+
+#include "test/test_bitcoin.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(sharded_lru_cache_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(sharded_lru_cache_test)
+{
+    sharded_lru_cache<uint256, int, StaticSaltedHasher, 10, 4> cache;
+
+    int value = 0;
+    BOOST_CHECK(!cache.get(ArithToUint256(1), value));
+    BOOST_CHECK_EQUAL(cache.hit_count(), 0);
+    BOOST_CHECK_EQUAL(cache.miss_count(), 1);
+
+    for (int i = 0; i < 20; i++) {
+        cache.insert(ArithToUint256(i), i);
+    }
+    for (int i = 0; i < 20; i++) {
+        BOOST_CHECK(cache.get(ArithToUint256(i), value));
+        BOOST_CHECK_EQUAL(value, i);
+    }
+    BOOST_CHECK_EQUAL(cache.hit_count(), 20);
+    BOOST_CHECK_EQUAL(cache.miss_count(), 1);
+
+    // overwrite and erase
+    cache.insert(ArithToUint256(5), 50);
+    BOOST_CHECK(cache.get(ArithToUint256(5), value));
+    BOOST_CHECK_EQUAL(value, 50);
+    cache.erase(ArithToUint256(5));
+    BOOST_CHECK(!cache.get(ArithToUint256(5), value));
+
+    // every shard evicts down to its own limit, the total stays bounded
+    for (int i = 0; i < 1000; i++) {
+        cache.insert(ArithToUint256(i), i);
+    }
+    int found = 0;
+    for (int i = 0; i < 1000; i++) {
+        if (cache.get(ArithToUint256(i), value)) {
+            found++;
+        }
+    }
+    BOOST_CHECK(found <= 4 * 10 * 2 + 4);
+    // the most recent insert is always kept
+    BOOST_CHECK(cache.get(ArithToUint256(999), value));
+
+    cache.clear();
+    BOOST_CHECK(!cache.get(ArithToUint256(999), value));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
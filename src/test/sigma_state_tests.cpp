@@ -560,9 +560,9 @@ BOOST_AUTO_TEST_CASE(sigma_getcoingroupinfo_existing)
     sigmaState->GetCoinGroupInfo(pubcoin.getDenomination(), 1, result);
     BOOST_CHECK_MESSAGE(result.nCoins == 1,
         "Unexpected number of coins in group.");
-    BOOST_CHECK_MESSAGE(result.firstBlock->mintedPubCoins.size() == index.mintedPubCoins.size(),
+    BOOST_CHECK_MESSAGE(result.firstBlock->GetPrivacyData().mintedPubCoins.size() == index.GetPrivacyData().mintedPubCoins.size(),
         "Unexpected first block index for Group info.");
-    BOOST_CHECK_MESSAGE(result.lastBlock->mintedPubCoins.size() == index.mintedPubCoins.size(),
+    BOOST_CHECK_MESSAGE(result.lastBlock->GetPrivacyData().mintedPubCoins.size() == index.GetPrivacyData().mintedPubCoins.size(),
         "Unexpected last block index for Group info.");
 
     sigmaState->Reset();
@@ -627,8 +627,8 @@ BOOST_AUTO_TEST_CASE(zerocoin_sigma_addblock_minted_spend)
     std::pair<sigma::CoinDenomination, int> denomination1Group1(
         sigma::CoinDenomination::SIGMA_DENOM_1,1);
 
-	index.sigmaMintedPubCoins[denomination1Group1].push_back(pubcoin1);
-	index.sigmaMintedPubCoins[denomination1Group1].push_back(pubcoin2);
+	index.GetPrivacyDataForUpdate().sigmaMintedPubCoins[denomination1Group1].push_back(pubcoin1);
+	index.GetPrivacyDataForUpdate().sigmaMintedPubCoins[denomination1Group1].push_back(pubcoin2);
 
 	sigmaState->AddBlock(&index);
 	BOOST_CHECK_MESSAGE(sigmaState->GetMints().size() == 2,
@@ -651,8 +651,8 @@ BOOST_AUTO_TEST_CASE(zerocoin_sigma_addblock_minted_spend)
 	auto spendSerial = coinSpend.getCoinSerialNumber();
 
     CBlockIndex index2 = CreateBlockIndex(2);
-	index2.sigmaSpentSerials.clear();
-	index2.sigmaSpentSerials.insert(std::make_pair(spendSerial, sigma::CSpendCoinInfo::make(coinSpend.getDenomination(), 0)));
+	index2.GetPrivacyDataForUpdate().sigmaSpentSerials.clear();
+	index2.GetPrivacyDataForUpdate().sigmaSpentSerials.insert(std::make_pair(spendSerial, sigma::CSpendCoinInfo::make(coinSpend.getDenomination(), 0)));
 	sigmaState->AddBlock(&index2);
 	BOOST_CHECK_MESSAGE(sigmaState->GetMints().size() == 2,
 	  "Unexpected mintedPubCoins size, add new block without additional minted.");
@@ -666,7 +666,7 @@ BOOST_AUTO_TEST_CASE(zerocoin_sigma_addblock_minted_spend)
     pubcoin3 = privcoin3.getPublicCoin();
     CBlockIndex index3 = CreateBlockIndex(3);
 
-    index3.sigmaMintedPubCoins[denomination1Group1].push_back(pubcoin3);
+    index3.GetPrivacyDataForUpdate().sigmaMintedPubCoins[denomination1Group1].push_back(pubcoin3);
     sigmaState->AddBlock(&index3);
     BOOST_CHECK_MESSAGE(sigmaState->GetMints().size() == 3,
 	  "Unexpected mintedPubCoins size, add new block with one more minted.");
@@ -689,7 +689,7 @@ BOOST_AUTO_TEST_CASE(zerocoin_sigma_removeblock_remove)
 
     auto index1 = CreateBlockIndex(1);
     std::pair<sigma::CoinDenomination, int> denomination1Group1(sigma::CoinDenomination::SIGMA_DENOM_1, 1);
-    index1.sigmaMintedPubCoins[denomination1Group1] = pubCoins;
+    index1.GetPrivacyDataForUpdate().sigmaMintedPubCoins[denomination1Group1] = pubCoins;
 
     // add index 2 with 10 minted and 1 spend
     auto coins2 = generateCoins(params,10, sigma::CoinDenomination::SIGMA_DENOM_1);
@@ -697,15 +697,15 @@ BOOST_AUTO_TEST_CASE(zerocoin_sigma_removeblock_remove)
 
     auto index2 = CreateBlockIndex(2);
     std::pair<sigma::CoinDenomination, int> denomination1Group2(sigma::CoinDenomination::SIGMA_DENOM_1, 2);
-    index2.sigmaMintedPubCoins[denomination1Group2] = pubCoins2;
+    index2.GetPrivacyDataForUpdate().sigmaMintedPubCoins[denomination1Group2] = pubCoins2;
 
     // Doesn't really matter what metadata we give here, it must pass.
     sigma::SpendMetaData metaData(0, uint256S("120"), uint256S("120"));
 
     sigma::CoinSpend coinSpend(params, coins[0], pubCoins, metaData, true);
 
-    index2.sigmaSpentSerials.clear();
-    index2.sigmaSpentSerials.insert(std::make_pair(coinSpend.getCoinSerialNumber(), sigma::CSpendCoinInfo::make(coinSpend.getDenomination(), 0)));
+    index2.GetPrivacyDataForUpdate().sigmaSpentSerials.clear();
+    index2.GetPrivacyDataForUpdate().sigmaSpentSerials.insert(std::make_pair(coinSpend.getCoinSerialNumber(), sigma::CSpendCoinInfo::make(coinSpend.getDenomination(), 0)));
 
     sigmaState->AddBlock(&index1);
     sigmaState->AddBlock(&index2);
@@ -922,7 +922,7 @@ BOOST_AUTO_TEST_CASE(sigma_build_state)
     std::pair<sigma::CoinDenomination, int> denomination1Group1(sigma::CoinDenomination::SIGMA_DENOM_1, 1);
     std::pair<sigma::CoinDenomination, int> denomination10Group1(sigma::CoinDenomination::SIGMA_DENOM_10, 1);
 
-    index1.sigmaMintedPubCoins[denomination1Group1] = pubCoins;
+    index1.GetPrivacyDataForUpdate().sigmaMintedPubCoins[denomination1Group1] = pubCoins;
 
     chainActive.SetTip(&index1);
 
@@ -937,10 +937,10 @@ BOOST_AUTO_TEST_CASE(sigma_build_state)
     secp_primitives::Scalar serial;
     serial.randomize();
 
-    index2.sigmaSpentSerials.insert(std::make_pair(serial, sigma::CSpendCoinInfo::make(sigma::CoinDenomination::SIGMA_DENOM_1, 0)));
+    index2.GetPrivacyDataForUpdate().sigmaSpentSerials.insert(std::make_pair(serial, sigma::CSpendCoinInfo::make(sigma::CoinDenomination::SIGMA_DENOM_1, 0)));
 
-    index2.sigmaMintedPubCoins[denomination1Group1] = pubCoins2;
-    index2.sigmaMintedPubCoins[denomination10Group1] = pubCoins3;
+    index2.GetPrivacyDataForUpdate().sigmaMintedPubCoins[denomination1Group1] = pubCoins2;
+    index2.GetPrivacyDataForUpdate().sigmaMintedPubCoins[denomination10Group1] = pubCoins3;
 
     chainActive.SetTip(&index2);
 
@@ -1060,7 +1060,7 @@ BOOST_AUTO_TEST_CASE(sigma_getcoinsetforspend)
     auto coins3 = generateCoins(params, 5, sigma::CoinDenomination::SIGMA_DENOM_10);
     auto pubCoins3 = getPubcoins(coins3);
 
-    indexes[nextIndex].sigmaMintedPubCoins[denomination1Group1] = pubCoins;
+    indexes[nextIndex].GetPrivacyDataForUpdate().sigmaMintedPubCoins[denomination1Group1] = pubCoins;
     chainActive.SetTip(&indexes[nextIndex]);
 
     nextIndex++;
@@ -1070,9 +1070,9 @@ BOOST_AUTO_TEST_CASE(sigma_getcoinsetforspend)
     secp_primitives::Scalar serial;
     serial.randomize();
 
-    indexes[nextIndex].sigmaSpentSerials.insert(std::make_pair(serial, sigma::CSpendCoinInfo::make(sigma::CoinDenomination::SIGMA_DENOM_1, 0)));
-    indexes[nextIndex].sigmaMintedPubCoins[denomination1Group1] = pubCoins2;
-    indexes[nextIndex].sigmaMintedPubCoins[denomination10Group1] = pubCoins3;
+    indexes[nextIndex].GetPrivacyDataForUpdate().sigmaSpentSerials.insert(std::make_pair(serial, sigma::CSpendCoinInfo::make(sigma::CoinDenomination::SIGMA_DENOM_1, 0)));
+    indexes[nextIndex].GetPrivacyDataForUpdate().sigmaMintedPubCoins[denomination1Group1] = pubCoins2;
+    indexes[nextIndex].GetPrivacyDataForUpdate().sigmaMintedPubCoins[denomination10Group1] = pubCoins3;
 
     chainActive.SetTip(&indexes[nextIndex]);
 
@@ -1116,6 +1116,130 @@ BOOST_AUTO_TEST_CASE(sigma_getcoinsetforspend)
     chainActive.SetTip(NULL);
 }
 
+BOOST_AUTO_TEST_CASE(sigma_getcoinsetforspend_add_remove_blocks)
+{
+    sigma::CSigmaState *sigmaState = sigma::CSigmaState::GetState();
+    sigma::Params* params = sigma::Params::get_default();
+    chainActive.SetTip(NULL);
+
+    std::pair<sigma::CoinDenomination, int> denomination1Group1(sigma::CoinDenomination::SIGMA_DENOM_1, 1);
+    std::vector<std::vector<sigma::PublicCoin>> pubCoins = {
+        {},
+        getPubcoins(generateCoins(params, 3, sigma::CoinDenomination::SIGMA_DENOM_1)),
+        {},
+        getPubcoins(generateCoins(params, 2, sigma::CoinDenomination::SIGMA_DENOM_1)),
+        getPubcoins(generateCoins(params, 4, sigma::CoinDenomination::SIGMA_DENOM_1))
+    };
+
+    // the coins of a group are listed newest block first
+    auto expectedSet = [&pubCoins](int maxHeight) {
+        std::vector<sigma::PublicCoin> result;
+        for (int i = std::min<int>(maxHeight, pubCoins.size() - 1); i >= 0; i--)
+            result.insert(result.end(), pubCoins[i].begin(), pubCoins[i].end());
+        return result;
+    };
+
+    std::vector<CBlockIndex> indexes(pubCoins.size() + 1);
+    for (std::size_t i = 0; i < pubCoins.size(); i++) {
+        indexes[i] = CreateBlockIndex(i);
+        if (!pubCoins[i].empty())
+            indexes[i].GetPrivacyDataForUpdate().sigmaMintedPubCoins[denomination1Group1] = pubCoins[i];
+        chainActive.SetTip(&indexes[i]);
+        sigmaState->AddBlock(&indexes[i]);
+    }
+
+    uint256 blockHash_out;
+    std::vector<sigma::PublicCoin> coins_out;
+    for (int maxHeight = 0; maxHeight <= 5; maxHeight++) {
+        auto expected = expectedSet(maxHeight);
+        auto coins_amount = sigmaState->GetCoinSetForSpend(&chainActive, maxHeight,
+            sigma::CoinDenomination::SIGMA_DENOM_1, 1, blockHash_out, coins_out);
+        BOOST_CHECK_EQUAL(coins_amount, (int)expected.size());
+        BOOST_CHECK(coins_out == expected);
+    }
+
+    // disconnect the last block and connect another one instead
+    sigmaState->RemoveBlock(&indexes[4]);
+    chainActive.SetTip(&indexes[3]);
+    BOOST_CHECK_EQUAL(sigmaState->GetCoinSetForSpend(&chainActive, 100,
+        sigma::CoinDenomination::SIGMA_DENOM_1, 1, blockHash_out, coins_out), 5);
+    pubCoins.pop_back();
+    BOOST_CHECK(coins_out == expectedSet(100));
+
+    pubCoins.push_back(getPubcoins(generateCoins(params, 1, sigma::CoinDenomination::SIGMA_DENOM_1)));
+    indexes[5] = CreateBlockIndex(4);
+    indexes[5].GetPrivacyDataForUpdate().sigmaMintedPubCoins[denomination1Group1] = pubCoins.back();
+    chainActive.SetTip(&indexes[5]);
+    sigmaState->AddBlock(&indexes[5]);
+    BOOST_CHECK_EQUAL(sigmaState->GetCoinSetForSpend(&chainActive, 100,
+        sigma::CoinDenomination::SIGMA_DENOM_1, 1, blockHash_out, coins_out), 6);
+    BOOST_CHECK(coins_out == expectedSet(100));
+
+    sigmaState->Reset();
+    chainActive.SetTip(NULL);
+}
+
+BOOST_AUTO_TEST_CASE(sigma_state_snapshot)
+{
+    sigma::CSigmaState *sigmaState = sigma::CSigmaState::GetState();
+    sigma::Params* params = sigma::Params::get_default();
+
+    LOCK(cs_main);
+    chainActive.SetTip(NULL);
+
+    // snapshots refer to blocks by hash, so the indexes have to be in mapBlockIndex
+    std::vector<CBlockIndex> indexes(2);
+    std::vector<uint256> hashes = {uint256S("f1"), uint256S("f2")};
+    for (int i = 0; i < 2; i++) {
+        indexes[i] = CreateBlockIndex(i);
+        indexes[i].phashBlock = &hashes[i];
+        mapBlockIndex[hashes[i]] = &indexes[i];
+        chainActive.SetTip(&indexes[i]);
+    }
+    CBlockIndex *index = &indexes[1];
+
+    auto pubCoins = getPubcoins(generateCoins(params, 2, sigma::CoinDenomination::SIGMA_DENOM_1));
+    auto mintsBlock = CreateBlockWithMints(pubCoins);
+    sigmaState->Reset();
+    sigmaState->AddMintsToStateAndBlockIndex(index, &mintsBlock);
+
+    secp_primitives::Scalar serial;
+    serial.randomize();
+    sigmaState->AddSpend(serial, sigma::CoinDenomination::SIGMA_DENOM_1, 1);
+
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    sigmaState->WriteSnapshot(ss);
+    sigmaState->Reset();
+    BOOST_CHECK(sigmaState->ReadSnapshot(ss));
+
+    BOOST_CHECK(sigmaState->HasCoin(pubCoins[0]) && sigmaState->HasCoin(pubCoins[1]));
+    BOOST_CHECK(sigmaState->IsUsedCoinSerial(serial));
+    BOOST_CHECK_EQUAL(sigmaState->GetLatestCoinID(sigma::CoinDenomination::SIGMA_DENOM_1), 1);
+
+    sigma::CSigmaState::SigmaCoinGroupInfo group;
+    BOOST_CHECK(sigmaState->GetCoinGroupInfo(sigma::CoinDenomination::SIGMA_DENOM_1, 1, group));
+    BOOST_CHECK(group.firstBlock == index && group.lastBlock == index);
+    BOOST_CHECK_EQUAL(group.nCoins, 2);
+
+    // the coin set is rebuilt from the index
+    uint256 blockHash_out;
+    std::vector<sigma::PublicCoin> coins_out;
+    BOOST_CHECK_EQUAL(sigmaState->GetCoinSetForSpend(&chainActive, index->nHeight,
+        sigma::CoinDenomination::SIGMA_DENOM_1, 1, blockHash_out, coins_out), 2);
+    BOOST_CHECK(blockHash_out == index->GetBlockHash());
+
+    // snapshots referring to blocks outside the active chain are rejected
+    CDataStream ss2(SER_DISK, CLIENT_VERSION);
+    sigmaState->WriteSnapshot(ss2);
+    chainActive.SetTip(&indexes[0]);
+    BOOST_CHECK(!sigmaState->ReadSnapshot(ss2));
+
+    for (const uint256 &hash : hashes)
+        mapBlockIndex.erase(hash);
+    sigmaState->Reset();
+    chainActive.SetTip(NULL);
+}
+
 namespace {
     Scalar generateSpend(sigma::CoinDenomination denom) {
         auto params = sigma::Params::get_default();
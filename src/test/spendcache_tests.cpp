@@ -0,0 +1,87 @@
+// Copyright (c) 2020 The TecraCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "spendcache.h"
+#include "arith_uint256.h"
+#include "util.h"
+
+#include "test/test_bitcoin.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(spendcache_tests, BasicTestingSetup)
+
+namespace {
+
+// Entry of a spend verified against the anonymity set fixed by blockHash
+uint256 MakeEntry(uint32_t spend, const uint256& blockHash = uint256())
+{
+    CHashWriter hasher = SpendCacheHasher();
+    hasher << ArithToUint256(arith_uint256(spend)) << blockHash;
+    return hasher.GetHash();
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(spendcache_hit_and_miss)
+{
+    // entries are salted, but stable within the process
+    BOOST_CHECK(MakeEntry(1) == MakeEntry(1));
+
+    BOOST_CHECK(!IsSpendProofCached(MakeEntry(1)));
+    AddSpendProofToCache(MakeEntry(1));
+    BOOST_CHECK(IsSpendProofCached(MakeEntry(1)));
+
+    // entries are not erased by a hit, the block is checked again when it is connected
+    BOOST_CHECK(IsSpendProofCached(MakeEntry(1)));
+
+    BOOST_CHECK(!IsSpendProofCached(MakeEntry(2)));
+}
+
+BOOST_AUTO_TEST_CASE(spendcache_invalidation)
+{
+    // the cache outlives the test, use spends of its own
+    uint256 blockHash = ArithToUint256(arith_uint256(1000));
+    AddSpendProofToCache(MakeEntry(10, blockHash));
+    BOOST_CHECK(IsSpendProofCached(MakeEntry(10, blockHash)));
+
+    // a spend verified against one anonymity set isn't taken as verified against another one
+    BOOST_CHECK(!IsSpendProofCached(MakeEntry(10, ArithToUint256(arith_uint256(1001)))));
+    BOOST_CHECK(!IsSpendProofCached(MakeEntry(10)));
+}
+
+BOOST_AUTO_TEST_CASE(spendcache_eviction)
+{
+    // 1MiB holds 32768 entries
+    ForceSetArg("-maxspendcachesize", "1");
+    InitSpendProofCache();
+    const uint32_t nMaxEntries = (1 << 20) / sizeof(uint256);
+
+    // all entries fit in the cache as long as it isn't full
+    for (uint32_t i = 0; i < nMaxEntries / 2; i++)
+        AddSpendProofToCache(MakeEntry(i));
+    uint32_t nCached = 0;
+    for (uint32_t i = 0; i < nMaxEntries / 2; i++)
+        nCached += IsSpendProofCached(MakeEntry(i));
+    BOOST_CHECK_EQUAL(nCached, nMaxEntries / 2);
+
+    // once it is, older entries are evicted
+    for (uint32_t i = nMaxEntries / 2; i < nMaxEntries * 4; i++)
+        AddSpendProofToCache(MakeEntry(i));
+    nCached = 0;
+    for (uint32_t i = 0; i < nMaxEntries * 4; i++)
+        nCached += IsSpendProofCached(MakeEntry(i));
+    BOOST_CHECK(nCached <= nMaxEntries);
+    BOOST_CHECK(nCached > nMaxEntries / 2);
+
+    uint32_t nOldCached = 0;
+    for (uint32_t i = 0; i < nMaxEntries / 2; i++)
+        nOldCached += IsSpendProofCached(MakeEntry(i));
+    BOOST_CHECK(nOldCached < nMaxEntries / 2);
+
+    ForceSetArg("-maxspendcachesize", std::to_string(DEFAULT_MAX_SPEND_CACHE_SIZE));
+    InitSpendProofCache();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
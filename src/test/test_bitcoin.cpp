@@ -26,6 +26,7 @@
 #include "rpc/server.h"
 #include "rpc/register.h"
 #include "script/sigcache.h"
+#include "spendcache.h"
 
 #include "test/testutil.h"
 
@@ -61,6 +62,7 @@ BasicTestingSetup::BasicTestingSetup(const std::string& chainName)
     SetupEnvironment();
     SetupNetworking();
     InitSignatureCache();
+    InitSpendProofCache();
     fPrintToDebugLog = false; // don't want to write to debug.log file
     fCheckBlockIndex = true;
     SelectParams(chainName);
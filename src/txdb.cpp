@@ -32,6 +32,12 @@ static const char DB_FLAG = 'F';
 static const char DB_REINDEX_FLAG = 'R';
 static const char DB_LAST_BLOCK = 'l';
 static const char DB_TOTAL_SUPPLY = 'S';
+static const char DB_PRIVACY_DATA = 'z';
+
+//! Value of the block index entry stored under the null hash, it marks an index whose zerocoin and sigma
+//! data is in the privacy index. Older versions check the version of the block index on the first entry.
+//! They can't read this one and force a reindex instead of loading blocks without their zerocoin and sigma data.
+static const uint8_t PRIVACY_INDEX_MARKER = 0;
 
 namespace {
 
@@ -106,7 +112,12 @@ size_t CCoinsViewDB::EstimateSize() const
     return db.EstimateSize(DB_COIN, (char)(DB_COIN+1));
 }
 
+static bool ReadBlockPrivacyDataFromBlockTree(const uint256 &hash, CBlockPrivacyData &data) {
+    return pblocktree && pblocktree->ReadPrivacyData(hash, data);
+}
+
 CBlockTreeDB::CBlockTreeDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "blocks" / "index", nCacheSize, fMemory, fWipe) {
+    ReadBlockPrivacyData = ReadBlockPrivacyDataFromBlockTree;
 }
 
 bool CBlockTreeDB::ReadBlockFileInfo(int nFile, CBlockFileInfo &info) {
@@ -189,12 +200,28 @@ bool CBlockTreeDB::WriteBatchSync(const std::vector<std::pair<int, const CBlockF
         batch.Write(std::make_pair(DB_BLOCK_FILES, it->first), *it->second);
     }
     batch.Write(DB_LAST_BLOCK, nLastFile);
+    batch.Write(std::make_pair(DB_BLOCK_INDEX, uint256()), PRIVACY_INDEX_MARKER);
     for (std::vector<const CBlockIndex*>::const_iterator it=blockinfo.begin(); it != blockinfo.end(); it++) {
-        batch.Write(std::make_pair(DB_BLOCK_INDEX, (*it)->GetBlockHash()), CDiskBlockIndex(*it));
+        WriteBlockIndex(batch, *it);
     }
     return WriteBatch(batch, true);
 }
 
+void CBlockTreeDB::WriteBlockIndex(CDBBatch &batch, const CBlockIndex *pindex) {
+    batch.Write(std::make_pair(DB_BLOCK_INDEX, pindex->GetBlockHash()), CDiskBlockIndex(pindex));
+    // privacy data which isn't loaded is unchanged since it was read
+    if (pindex->IsPrivacyDataLoaded()) {
+        if (pindex->HasPrivacyData())
+            batch.Write(std::make_pair(DB_PRIVACY_DATA, pindex->GetBlockHash()), pindex->GetPrivacyData());
+        else
+            batch.Erase(std::make_pair(DB_PRIVACY_DATA, pindex->GetBlockHash()));
+    }
+}
+
+bool CBlockTreeDB::ReadPrivacyData(const uint256 &hash, CBlockPrivacyData &data) {
+    return Read(std::make_pair(DB_PRIVACY_DATA, hash), data);
+}
+
 bool CBlockTreeDB::ReadTxIndex(const uint256 &txid, CDiskTxPos &pos) {
     return Read(std::make_pair(DB_TXINDEX, txid), pos);
 }
@@ -354,15 +381,23 @@ bool CBlockTreeDB::LoadBlockIndexGuts(boost::function<CBlockIndex*(const uint256
 
     pcursor->Seek(std::make_pair(DB_BLOCK_INDEX, uint256()));
 
+    std::vector<const CBlockIndex*> legacyIndexes;
+
     // Load mapBlockIndex
     while (pcursor->Valid()) {
         boost::this_thread::interruption_point();
         std::pair<char, uint256> key;
         if (pcursor->GetKey(key) && key.first == DB_BLOCK_INDEX) {
+            if (key.second.IsNull()) {
+                // privacy index marker
+                pcursor->Next();
+                continue;
+            }
             CDiskBlockIndex diskindex;
             if (pcursor->GetValue(diskindex)) {
-                // Construct block index object
-                CBlockIndex* pindexNew    = insertBlockIndex(diskindex.GetBlockHash());
+                // Construct block index object. Entries are stored under their hash, taking it
+                // from the key saves running Lyra2Z over every header
+                CBlockIndex* pindexNew    = insertBlockIndex(key.second);
                 pindexNew->pprev 		  = insertBlockIndex(diskindex.hashPrev);
                 pindexNew->nHeight        = diskindex.nHeight;
                 pindexNew->nFile          = diskindex.nFile;
@@ -373,7 +408,7 @@ bool CBlockTreeDB::LoadBlockIndexGuts(boost::function<CBlockIndex*(const uint256
                 pindexNew->nTime          = diskindex.nTime;
                 pindexNew->nBits          = diskindex.nBits;
                 pindexNew->nNonce         = diskindex.nNonce;
-                pindexNew->nStatus        = diskindex.nStatus;
+                pindexNew->nStatus        = diskindex.nStatus & ~BLOCK_HAVE_PRIVACY_DATA;
                 pindexNew->nTx            = diskindex.nTx;
 
                 // TecraCoin - MTP
@@ -384,13 +419,18 @@ bool CBlockTreeDB::LoadBlockIndexGuts(boost::function<CBlockIndex*(const uint256
                     pindexNew->reserved[1] = diskindex.reserved[1];
                 }
 
-                pindexNew->accumulatorChanges = diskindex.accumulatorChanges;
-                pindexNew->mintedPubCoins     = diskindex.mintedPubCoins;
-                pindexNew->spentSerials       = diskindex.spentSerials;
-
-                pindexNew->sigmaMintedPubCoins   = diskindex.sigmaMintedPubCoins;
-                pindexNew->sigmaSpentSerials     = diskindex.sigmaSpentSerials;
+                // Zerocoin and sigma data is read from the privacy index when first used. Entries
+                // written by older versions have it inline, these are moved to the privacy index
+                if (diskindex.legacyPrivacyData) {
+                    pindexNew->GetPrivacyDataForUpdate() = std::move(*diskindex.legacyPrivacyData);
+                    legacyIndexes.push_back(pindexNew);
+                }
+                else if (diskindex.nStatus & BLOCK_HAVE_PRIVACY_DATA) {
+                    pindexNew->SetPrivacyDataOnDisk();
+                }
 
+                // The key is the Lyra2Z hash of the header, so this doesn't hash the header again.
+                // LoadBlockIndexDB recomputes the hashes with -checkindexpow
                 if (!CheckProofOfWork(pindexNew->GetBlockPoWHash(), pindexNew->nBits, consensusParams))
                     return error("LoadBlockIndex(): CheckProofOfWork failed: %s", pindexNew->ToString());
 
@@ -403,6 +443,17 @@ bool CBlockTreeDB::LoadBlockIndexGuts(boost::function<CBlockIndex*(const uint256
         }
     }
 
+    if (!legacyIndexes.empty()) {
+        LogPrintf("LoadBlockIndex(): moving zerocoin and sigma data of %d blocks to the privacy index\n", legacyIndexes.size());
+        CDBBatch batch(*this);
+        batch.Write(std::make_pair(DB_BLOCK_INDEX, uint256()), PRIVACY_INDEX_MARKER);
+        for (const CBlockIndex *pindex : legacyIndexes) {
+            WriteBlockIndex(batch, pindex);
+        }
+        if (!WriteBatch(batch, true))
+            return error("LoadBlockIndex(): failed to write the privacy index");
+    }
+
     return true;
 }
 
@@ -424,7 +475,7 @@ int CBlockTreeDB::GetBlockIndexVersion(uint256 const & blockHash)
         boost::this_thread::interruption_point();
         std::pair<char, uint256> key;
         if (pcursor->GetKey(key) && key.first == DB_BLOCK_INDEX) {
-            if (blockHash != zero_hash && key.second != blockHash) {
+            if ((blockHash != zero_hash && key.second != blockHash) || key.second == zero_hash) {
                 pcursor->Next();
                 continue;
             }
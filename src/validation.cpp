@@ -205,6 +205,9 @@ namespace {
 
     /** Dirty block file entries. */
     std::set<int> setDirtyFileInfo;
+
+    /** Whether the zerocoin and sigma states match chainActive, so they may be written to a snapshot. */
+    bool fPrivacyStateBuilt = false;
 } // anon namespace
 
 int GetHeight()
@@ -569,7 +572,7 @@ int GetUTXOConfirmations(const COutPoint& outpoint)
     return (nPrevoutHeight > -1 && chainActive.Tip()) ? chainActive.Height() - nPrevoutHeight + 1 : -1;
 }
 
-bool CheckTransaction(const CTransaction &tx, CValidationState &state, bool fCheckDuplicateInputs, uint256 hashTx,  bool isVerifyDB, int nHeight, bool isCheckWallet, bool fStatefulZerocoinCheck, CZerocoinTxInfo *zerocoinTxInfo, sigma::CSigmaTxInfo *sigmaTxInfo)
+bool CheckTransaction(const CTransaction &tx, CValidationState &state, bool fCheckDuplicateInputs, uint256 hashTx,  bool isVerifyDB, int nHeight, bool isCheckWallet, bool fStatefulZerocoinCheck, CZerocoinTxInfo *zerocoinTxInfo, sigma::CSigmaTxInfo *sigmaTxInfo, sigma::CSigmaSpendBatch *sigmaSpendBatch)
 {
     LogPrintf("CheckTransaction nHeight=%s, isVerifyDB=%s, isCheckWallet=%s, txHash=%s\n", nHeight, isVerifyDB, isCheckWallet, tx.GetHash().ToString());
 
@@ -644,7 +647,7 @@ bool CheckTransaction(const CTransaction &tx, CValidationState &state, bool fChe
                 return state.DoS(10, false, REJECT_INVALID, "bad-txns-prevout-null");
                 
         if (tx.IsZerocoinV3SigmaTransaction()) {
-            if (fRejectSigma || !CheckSigmaTransaction(tx, state, hashTx, isVerifyDB, nHeight, isCheckWallet, fStatefulZerocoinCheck, sigmaTxInfo))
+            if (fRejectSigma || !CheckSigmaTransaction(tx, state, hashTx, isVerifyDB, nHeight, isCheckWallet, fStatefulZerocoinCheck, sigmaTxInfo, sigmaSpendBatch))
                 return false;
         }
 
@@ -2203,6 +2206,20 @@ void ThreadScriptCheck() {
     scriptcheckqueue.Thread();
 }
 
+static CCheckQueue<CBlockHeaderCheck> headercheckqueue(16);
+
+void ThreadHeaderCheck() {
+    RenameThread("bitcoin-headerch");
+    headercheckqueue.Thread();
+}
+
+static CCheckQueue<sigma::CSigmaSpendCheck> sigmacheckqueue(1);
+
+void ThreadSigmaCheck() {
+    RenameThread("bitcoin-sigmach");
+    sigmacheckqueue.Thread();
+}
+
 // Protected by cs_main
 VersionBitsCache versionbitscache;
 
@@ -2426,6 +2443,7 @@ bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pin
 
     block.zerocoinTxInfo = std::make_shared<CZerocoinTxInfo>();
     block.sigmaTxInfo = std::make_shared<sigma::CSigmaTxInfo>();
+    sigma::CSigmaSpendBatch sigmaSpendBatch;
 
     for (unsigned int i = 0; i < block.vtx.size(); i++)
     {
@@ -2465,7 +2483,7 @@ bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pin
                 nFees += sigma::GetSigmaSpendInput(tx) - tx.GetValueOut();
 
             // Check transaction against zerocoin state
-            if (!CheckTransaction(tx, state, false, txHash, false, pindex->nHeight, false, true, block.zerocoinTxInfo.get(), block.sigmaTxInfo.get()))
+            if (!CheckTransaction(tx, state, false, txHash, false, pindex->nHeight, false, true, block.zerocoinTxInfo.get(), block.sigmaTxInfo.get(), &sigmaSpendBatch))
                 return state.DoS(100, error("stateful zerocoin check failed"),
                                  REJECT_INVALID, "bad-txns-zerocoin");
         }
@@ -2512,11 +2530,28 @@ bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pin
     block.zerocoinTxInfo->Complete();
     block.sigmaTxInfo->Complete();
 
+    // Sigma proofs are verified on their own queue while the script checks run
+    CCheckQueueControl<sigma::CSigmaSpendCheck> sigmaControl(nScriptCheckThreads ? &sigmacheckqueue : NULL);
+    if (sigmaSpendBatch.GetSpendCount() > 0) {
+        if (nScriptCheckThreads) {
+            std::vector<sigma::CSigmaSpendCheck> vSigmaChecks;
+            sigmaSpendBatch.GetChecks(vSigmaChecks, nScriptCheckThreads);
+            sigmaControl.Add(vSigmaChecks);
+        }
+        else if (!sigmaSpendBatch.Verify()) {
+            return state.DoS(100, error("ConnectBlock(): sigma spend proof verification failed"),
+                             REJECT_INVALID, "bad-txns-zerocoin");
+        }
+    }
+
     int64_t nTime3 = GetTimeMicros(); nTimeConnect += nTime3 - nTime2;
     LogPrint("bench", "      - Connect %u transactions: %.2fms (%.3fms/tx, %.3fms/txin) [%.2fs]\n", (unsigned)block.vtx.size(), 0.001 * (nTime3 - nTime2), 0.001 * (nTime3 - nTime2) / block.vtx.size(), nInputs <= 1 ? 0 : 0.001 * (nTime3 - nTime2) / (nInputs-1), nTimeConnect * 0.000001);
 
     if (!control.Wait())
         return state.DoS(100, false);
+    if (!sigmaControl.Wait())
+        return state.DoS(100, error("ConnectBlock(): sigma spend proof verification failed"),
+                         REJECT_INVALID, "bad-txns-zerocoin");
     int64_t nTime4 = GetTimeMicros(); nTimeVerify += nTime4 - nTime2;
     LogPrint("bench", "    - Verify %u txins: %.2fms (%.3fms/txin) [%.2fs]\n", nInputs - 1, 0.001 * (nTime4 - nTime2), nInputs <= 1 ? 0 : 0.001 * (nTime4 - nTime2) / (nInputs-1), nTimeVerify * 0.000001);
 
@@ -2797,6 +2832,8 @@ bool static FlushStateToDisk(CValidationState &state, FlushStateMode mode, int n
         if (!evoDb->CommitRootTransaction()) {
             return AbortNode(state, "Failed to commit EvoDB");
         }
+        if (fPeriodicFlush)
+            DumpPrivacyState();
         nLastFlush = nNow;
     }
     if (fDoFullFlush || ((mode == FLUSH_STATE_ALWAYS || mode == FLUSH_STATE_PERIODIC) && nNow > nLastSetChain + (int64_t)DATABASE_WRITE_INTERVAL * 1000000)) {
@@ -3806,6 +3843,32 @@ bool CheckBlockHeader(const CBlockHeader& block, CValidationState& state, const
     return true;
 }
 
+bool CBlockHeaderCheck::operator()() {
+    // GetHash() is needed for the linkage checks later on, compute it here as well
+    pheader->GetHash();
+    return CheckProofOfWork(pheader->GetPoWHash(INT_MAX), pheader->nBits, *pparams);
+}
+
+bool CheckBlockHeadersProofOfWork(const std::vector<CBlockHeader>& headers, const Consensus::Params& consensusParams)
+{
+    if (!nScriptCheckThreads) {
+        for (const CBlockHeader& header : headers) {
+            if (!CBlockHeaderCheck(header, consensusParams)())
+                return false;
+        }
+        return true;
+    }
+
+    std::vector<CBlockHeaderCheck> vChecks;
+    vChecks.reserve(headers.size());
+    for (const CBlockHeader& header : headers)
+        vChecks.emplace_back(header, consensusParams);
+
+    CCheckQueueControl<CBlockHeaderCheck> control(&headercheckqueue);
+    control.Add(vChecks);
+    return control.Wait();
+}
+
 bool CheckBlock(const CBlock& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW, bool fCheckMerkleRoot, int nHeight, bool isVerifyDB) {
     // CheckBlock not only checks the block, but also fills up zerocoinTxInfo and sigmaTxInfo.
     if (!block.zerocoinTxInfo)
@@ -4547,6 +4610,48 @@ CBlockIndex * InsertBlockIndex(uint256 hash)
     return pindexNew;
 }
 
+/** Recompute the hashes of all the headers in the index and check them against their keys and
+ *  their targets. The headers are hashed in batches on the header check threads */
+bool static CheckBlockIndexHeaders(const Consensus::Params& consensusParams)
+{
+    const size_t nBatchSize = 4096;
+    int64_t nStart = GetTimeMillis();
+
+    std::vector<CBlockHeader> headers;
+    std::vector<const CBlockIndex*> indexes;
+    headers.reserve(nBatchSize);
+    indexes.reserve(nBatchSize);
+
+    auto checkBatch = [&]() {
+        boost::this_thread::interruption_point();
+        if (!CheckBlockHeadersProofOfWork(headers, consensusParams))
+            return error("%s: CheckProofOfWork failed", __func__);
+        for (size_t i = 0; i < headers.size(); i++) {
+            if (headers[i].GetHash() != indexes[i]->GetBlockHash())
+                return error("%s: header hash mismatch: %s", __func__, indexes[i]->ToString());
+        }
+        headers.clear();
+        indexes.clear();
+        return true;
+    };
+
+    BOOST_FOREACH(const PAIRTYPE(uint256, CBlockIndex*)& item, mapBlockIndex)
+    {
+        CBlockHeader header = item.second->GetBlockHeader();
+        // drop the hash taken from the key so that the header is hashed again
+        header.SetCachedHash(uint256());
+        headers.push_back(header);
+        indexes.push_back(item.second);
+        if (headers.size() == nBatchSize && !checkBatch())
+            return false;
+    }
+    if (!headers.empty() && !checkBatch())
+        return false;
+
+    LogPrintf("%s: checked %u headers in %dms\n", __func__, mapBlockIndex.size(), GetTimeMillis() - nStart);
+    return true;
+}
+
 bool static LoadBlockIndexDB(const CChainParams& chainparams)
 {
     LogPrintf("LoadBlockIndexDB\n");
@@ -4555,6 +4660,9 @@ bool static LoadBlockIndexDB(const CChainParams& chainparams)
 
     boost::this_thread::interruption_point();
 
+    if (GetBoolArg("-checkindexpow", DEFAULT_CHECK_INDEX_POW) && !CheckBlockIndexHeaders(chainparams.GetConsensus()))
+        return false;
+
     // Calculate nChainWork
     std::vector<std::pair<int, CBlockIndex*> > vSortedByHeight;
     vSortedByHeight.reserve(mapBlockIndex.size());
@@ -4670,8 +4778,10 @@ bool static LoadBlockIndexDB(const CChainParams& chainparams)
 
     // some blocks in index can change as a result of ZerocoinBuildStateFromIndex() call
     set<CBlockIndex *> changes;
-    ZerocoinBuildStateFromIndex(&chainActive, changes);
-    sigma::BuildSigmaStateFromIndex(&chainActive);
+    CBlockIndex *pindexSnapshot = LoadPrivacyState();
+    ZerocoinBuildStateFromIndex(&chainActive, changes, pindexSnapshot);
+    sigma::BuildSigmaStateFromIndex(&chainActive, pindexSnapshot);
+    fPrivacyStateBuilt = true;
     if (!changes.empty()) {
         setDirtyBlockIndex.insert(changes.begin(), changes.end());
         FlushStateToDisk();
@@ -4888,6 +4998,7 @@ void UnloadBlockIndex()
     LOCK(cs_main);
     setBlockIndexCandidates.clear();
     chainActive.SetTip(NULL);
+    fPrivacyStateBuilt = false;
     pindexBestInvalid = NULL;
     pindexBestHeader = NULL;
     txpools.clear();
@@ -4925,6 +5036,9 @@ bool InitBlockIndex(const CChainParams& chainparams)
     if (chainActive.Genesis() != NULL)
         return true;
 
+    // A new chain is connected from the genesis block, which builds the zerocoin and sigma states along with it
+    fPrivacyStateBuilt = true;
+
     // Use the provided setting for -txindex in the new database
     fTxIndex = GetBoolArg("-txindex", DEFAULT_TXINDEX);
     pblocktree->WriteFlag("txindex", fTxIndex);
@@ -5290,6 +5404,90 @@ int VersionBitsTipStateSinceHeight(const Consensus::Params& params, Consensus::D
     return VersionBitsStateSinceHeight(chainActive.Tip(), params, pos, versionbitscache);
 }
 
+static const uint64_t PRIVACY_STATE_DUMP_VERSION = 1;
+
+CBlockIndex* LoadPrivacyState()
+{
+    AssertLockHeld(cs_main);
+
+    boost::filesystem::path path = GetDataDir() / "privacystate.dat";
+    FILE* filestr = fopen(path.string().c_str(), "rb");
+    CAutoFile file(filestr, SER_DISK, CLIENT_VERSION);
+    if (file.IsNull())
+        return NULL;
+
+    int64_t nStart = GetTimeMillis();
+    CBlockIndex* pindexSnapshot = NULL;
+    try {
+        uint64_t version;
+        file >> version;
+        if (version != PRIVACY_STATE_DUMP_VERSION)
+            return NULL;
+
+        std::vector<char> data;
+        uint256 hashIn;
+        file >> data >> hashIn;
+        if (Hash(data.begin(), data.end()) != hashIn) {
+            LogPrintf("%s: checksum mismatch, building the state from the index\n", __func__);
+            return NULL;
+        }
+
+        CDataStream ss(data, SER_DISK, CLIENT_VERSION);
+        // the snapshot is usable if it was taken at a block of the active chain, later blocks are added to it
+        if (!ReadStateSnapshotBlock(ss, pindexSnapshot) ||
+                !CZerocoinState::GetZerocoinState()->ReadSnapshot(ss) ||
+                !sigma::CSigmaState::GetState()->ReadSnapshot(ss)) {
+            LogPrintf("%s: snapshot is not on the active chain, building the state from the index\n", __func__);
+            pindexSnapshot = NULL;
+        }
+    } catch (const std::exception& e) {
+        LogPrintf("%s: failed to deserialize the snapshot: %s\n", __func__, e.what());
+        pindexSnapshot = NULL;
+    }
+
+    if (!pindexSnapshot) {
+        CZerocoinState::GetZerocoinState()->Reset();
+        sigma::CSigmaState::GetState()->Reset();
+        return NULL;
+    }
+
+    LogPrintf("Loaded zerocoin and sigma state at height %d: %dms\n", pindexSnapshot->nHeight, GetTimeMillis() - nStart);
+    return pindexSnapshot;
+}
+
+void DumpPrivacyState()
+{
+    AssertLockHeld(cs_main);
+
+    if (!fPrivacyStateBuilt || !chainActive.Tip())
+        return;
+
+    int64_t nStart = GetTimeMillis();
+
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    WriteStateSnapshotBlock(ss, chainActive.Tip());
+    CZerocoinState::GetZerocoinState()->WriteSnapshot(ss);
+    sigma::CSigmaState::GetState()->WriteSnapshot(ss);
+    std::vector<char> data(ss.begin(), ss.end());
+
+    try {
+        FILE* filestr = fopen((GetDataDir() / "privacystate.dat.new").string().c_str(), "wb");
+        if (!filestr) {
+            return;
+        }
+
+        CAutoFile file(filestr, SER_DISK, CLIENT_VERSION);
+        file << PRIVACY_STATE_DUMP_VERSION;
+        file << data << Hash(data.begin(), data.end());
+        FileCommit(file.Get());
+        file.fclose();
+        RenameOver(GetDataDir() / "privacystate.dat.new", GetDataDir() / "privacystate.dat");
+        LogPrintf("Dumped zerocoin and sigma state at height %d: %dms\n", chainActive.Height(), GetTimeMillis() - nStart);
+    } catch (const std::exception& e) {
+        LogPrintf("Failed to dump zerocoin and sigma state: %s. Continuing anyway.\n", e.what());
+    }
+}
+
 static const uint64_t MEMPOOL_DUMP_VERSION = 1;
 
 bool LoadMempool(void)
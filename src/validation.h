@@ -53,6 +53,8 @@ struct ChainTxData;
 struct PrecomputedTransactionData;
 struct LockPoints;
 
+namespace sigma { class CSigmaSpendBatch; }
+
 
 /** Default for DEFAULT_WHITELISTRELAY. */
 static const bool DEFAULT_WHITELISTRELAY = true;
@@ -231,6 +233,8 @@ static const unsigned int MIN_BLOCKS_TO_KEEP = 288;
 
 static const signed int DEFAULT_CHECKBLOCKS = 6;
 static const unsigned int DEFAULT_CHECKLEVEL = 3;
+/** Recompute the header hashes of the block index at startup instead of trusting the stored ones */
+static const bool DEFAULT_CHECK_INDEX_POW = false;
 
 // Require that user allocate at least 550MB for block & undo files (blk???.dat and rev???.dat)
 // At 1MB per block, 288 blocks = 288MB.
@@ -293,6 +297,10 @@ bool LoadBlockIndex(const CChainParams& chainparams);
 void UnloadBlockIndex();
 /** Run an instance of the script checking thread */
 void ThreadScriptCheck();
+/** Run an instance of the block header proof-of-work checking thread */
+void ThreadHeaderCheck();
+/** Run an instance of the sigma spend proof checking thread */
+void ThreadSigmaCheck();
 /** Check whether we are doing an initial block download (synchronizing from disk or network) */
 bool IsInitialBlockDownload();
 /** Format a string that describes several potential problems detected by the core.
@@ -421,7 +429,7 @@ void UpdateCoins(const CTransaction& tx, CCoinsViewCache& inputs, int nHeight);
 /** Transaction validation functions */
 
 /** Context-independent validity checks */
-bool CheckTransaction(const CTransaction& tx, CValidationState& state, bool fCheckDuplicateInputs, uint256 hashTx, bool isVerifyDB, int nHeight = INT_MAX, bool isCheckWallet = false, bool fStatefulZerocoinCheck = true, CZerocoinTxInfo *zerocoinTxInfo = NULL, sigma::CSigmaTxInfo *sigmaTxInfo = NULL);
+bool CheckTransaction(const CTransaction& tx, CValidationState& state, bool fCheckDuplicateInputs, uint256 hashTx, bool isVerifyDB, int nHeight = INT_MAX, bool isCheckWallet = false, bool fStatefulZerocoinCheck = true, CZerocoinTxInfo *zerocoinTxInfo = NULL, sigma::CSigmaTxInfo *sigmaTxInfo = NULL, sigma::CSigmaSpendBatch *sigmaSpendBatch = NULL);
 
 namespace Consensus {
 
@@ -517,6 +525,29 @@ public:
     ScriptError GetScriptError() const { return error; }
 };
 
+/**
+ * Closure representing the context-free proof-of-work check of one block header.
+ * Computing the header hash dominates, so these are spread over the header check threads.
+ */
+class CBlockHeaderCheck
+{
+private:
+    const CBlockHeader *pheader;
+    const Consensus::Params *pparams;
+
+public:
+    CBlockHeaderCheck(): pheader(0), pparams(0) {}
+    CBlockHeaderCheck(const CBlockHeader& headerIn, const Consensus::Params& paramsIn) :
+        pheader(&headerIn), pparams(&paramsIn) { }
+
+    bool operator()();
+
+    void swap(CBlockHeaderCheck &check) {
+        std::swap(pheader, check.pheader);
+        std::swap(pparams, check.pparams);
+    }
+};
+
 bool GetTimestampIndex(const unsigned int &high, const unsigned int &low, std::vector<uint256> &hashes);
 bool GetSpentIndex(CSpentIndexKey &key, CSpentIndexValue &value);
 bool GetAddressIndex(uint160 addressHash, AddressType type,
@@ -534,6 +565,10 @@ bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus
 
 /** Context-independent validity checks */
 bool CheckBlockHeader(const CBlockHeader& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW = true);
+/** Hash and check proof of work of a batch of headers on the header check threads. Only the
+ *  context-free part is done here, chain linkage is left to the serial ProcessNewBlockHeaders.
+ *  Warms up the per-header hash memo, so it is worth calling before taking cs_main. */
+bool CheckBlockHeadersProofOfWork(const std::vector<CBlockHeader>& headers, const Consensus::Params& consensusParams);
 bool CheckBlock(const CBlock& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW = true, bool fCheckMerkleRoot = true, int nHeight = INT_MAX, bool isVerifyDB = false);
 
 bool IsTransactionInChain(const uint256& txId, int& nHeightTx, CTransactionRef tx);
@@ -637,6 +672,12 @@ CBlockFileInfo* GetBlockFileInfo(size_t n);
 /** Dump the mempool to disk. */
 void DumpMempool();
 
+/** Write the zerocoin and sigma states at the chain tip to disk, so they needn't be built from the index on startup. */
+void DumpPrivacyState();
+
+/** Read the zerocoin and sigma states from disk. Returns the block they were written at or NULL if they can't be used. */
+CBlockIndex* LoadPrivacyState();
+
 /** Load the mempool from disk. */
 bool LoadMempool();
 
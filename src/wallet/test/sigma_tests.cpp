@@ -86,7 +86,7 @@ static void GenerateBlockWithCoins(const std::vector<std::pair<sigma::CoinDenomi
 
             auto& pub = priv.getPublicCoin();
 
-            block->second.sigmaMintedPubCoins[std::make_pair(coin.first, 1)].push_back(pub);
+            block->second.GetPrivacyDataForUpdate().sigmaMintedPubCoins[std::make_pair(coin.first, 1)].push_back(pub);
 
             if (addToWallet) {
                 zwalletMain->GetTracker().Add(dMint, true);
@@ -0,0 +1,135 @@
+// Copyright (c) 2020 The TecraCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "wallet/wallet.h"
+#include "wallet/walletdb.h"
+
+#include "arith_uint256.h"
+#include "chainparams.h"
+#include "consensus/validation.h"
+#include "validation.h"
+#include "zerocoin.h"
+
+#include "wallet/test/wallet_test_fixture.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <deque>
+#include <vector>
+
+namespace {
+
+// Chain of standalone block indexes with zerocoin mints, replacing the chain of the fixture while it exists
+class ZerocoinTestChain
+{
+public:
+    ZerocoinTestChain() : pindexSaved(chainActive.Tip())
+    {
+        CZerocoinState::GetZerocoinState()->Reset();
+        chainActive.SetTip(NULL);
+    }
+
+    ~ZerocoinTestChain()
+    {
+        for (const uint256& hash : hashes)
+            mapBlockIndex.erase(hash);
+        CZerocoinState::GetZerocoinState()->Reset();
+        chainActive.SetTip(pindexSaved);
+    }
+
+    void AddBlock(libzerocoin::CoinDenomination denomination, const std::vector<CBigNum>& mints = {})
+    {
+        hashes.push_back(ArithToUint256(arith_uint256(0xf000 + hashes.size())));
+        indexes.emplace_back();
+        CBlockIndex& index = indexes.back();
+        index.nHeight = chainActive.Height() + 1;
+        index.pprev = chainActive.Tip();
+        index.phashBlock = &hashes.back();
+        mapBlockIndex[hashes.back()] = &index;
+        chainActive.SetTip(&index);
+
+        CBlock block;
+        block.zerocoinTxInfo = std::make_shared<CZerocoinTxInfo>();
+        for (const CBigNum& mint : mints)
+            block.zerocoinTxInfo->mints.push_back(std::make_pair((int)denomination, mint));
+        block.zerocoinTxInfo->Complete();
+
+        CValidationState state;
+        BOOST_CHECK(ConnectBlockZC(state, Params(), &index, &block));
+    }
+
+private:
+    CBlockIndex* pindexSaved;
+    // deques keep the addresses of their elements
+    std::deque<uint256> hashes;
+    std::deque<CBlockIndex> indexes;
+};
+
+}
+
+BOOST_FIXTURE_TEST_SUITE(wallet_zerocoin_tests, WalletTestingSetup)
+
+BOOST_AUTO_TEST_CASE(zerocoin_witness_cache)
+{
+    LOCK2(cs_main, pwalletMain->cs_wallet);
+
+    const libzerocoin::CoinDenomination denomination = libzerocoin::ZQ_LOVELACE;
+    const bool fModulusV2 = IsZerocoinTxV2(denomination, Params().GetConsensus(), 1);
+    libzerocoin::Params* zcParams = fModulusV2 ? ZCParamsV2 : ZCParams;
+    std::vector<CBigNum> pubCoins;
+    for (int i = 0; i < 4; i++)
+        pubCoins.push_back(libzerocoin::PrivateCoin(zcParams, denomination).getPublicCoin().getValue());
+    const CBigNum& pubCoin = pubCoins[0];
+
+    ZerocoinTestChain chain;
+    chain.AddBlock(denomination);
+    chain.AddBlock(denomination, {pubCoins[0], pubCoins[1]});
+    chain.AddBlock(denomination, {pubCoins[2]});
+    chain.AddBlock(denomination);
+
+    CZerocoinState* zerocoinState = CZerocoinState::GetZerocoinState();
+    CWalletDB walletdb(pwalletMain->strWalletFile);
+    CZerocoinWitnessEntry entry;
+    BOOST_CHECK(!walletdb.ReadZerocoinWitness(pubCoin, fModulusV2, entry));
+
+    // a cold cache computes the witness from the index, and stores it at the last block it includes
+    libzerocoin::AccumulatorWitness expected =
+        zerocoinState->GetWitnessForSpend(&chainActive, chainActive.Height(), denomination, 1, pubCoin, fModulusV2);
+    libzerocoin::AccumulatorWitness cold =
+        pwalletMain->GetZerocoinWitness(chainActive.Height(), denomination, 1, pubCoin, fModulusV2);
+    BOOST_CHECK(cold.getValue() == expected.getValue());
+    BOOST_CHECK(walletdb.ReadZerocoinWitness(pubCoin, fModulusV2, entry));
+    BOOST_CHECK(entry.blockHash == chainActive.Tip()->GetBlockHash());
+    BOOST_CHECK(entry.witnessValue == cold.getValue());
+
+    // a warm one returns the same witness
+    libzerocoin::AccumulatorWitness warm =
+        pwalletMain->GetZerocoinWitness(chainActive.Height(), denomination, 1, pubCoin, fModulusV2);
+    BOOST_CHECK(warm.getValue() == cold.getValue());
+
+    // and only adds the coins of new blocks to it
+    chain.AddBlock(denomination, {pubCoins[3]});
+    chain.AddBlock(denomination);
+    libzerocoin::AccumulatorWitness expectedAdvanced =
+        zerocoinState->GetWitnessForSpend(&chainActive, chainActive.Height(), denomination, 1, pubCoin, fModulusV2);
+    BOOST_CHECK(expectedAdvanced.getValue() != cold.getValue());
+    libzerocoin::AccumulatorWitness advanced =
+        pwalletMain->GetZerocoinWitness(chainActive.Height(), denomination, 1, pubCoin, fModulusV2);
+    BOOST_CHECK(advanced.getValue() == expectedAdvanced.getValue());
+    BOOST_CHECK(walletdb.ReadZerocoinWitness(pubCoin, fModulusV2, entry));
+    BOOST_CHECK(entry.blockHash == chainActive.Tip()->GetBlockHash());
+    BOOST_CHECK(entry.witnessValue == advanced.getValue());
+
+    libzerocoin::Accumulator accumulator(zcParams, denomination);
+    for (const CBigNum& coin : pubCoins)
+        accumulator += libzerocoin::PublicCoin(zcParams, coin, denomination);
+    BOOST_CHECK(advanced.VerifyWitness(accumulator, libzerocoin::PublicCoin(zcParams, pubCoin, denomination)));
+
+    // a witness for an earlier height can't use the cached one
+    libzerocoin::AccumulatorWitness earlier = pwalletMain->GetZerocoinWitness(2, denomination, 1, pubCoin, fModulusV2);
+    BOOST_CHECK(earlier.getValue() ==
+        zerocoinState->GetWitnessForSpend(&chainActive, 2, denomination, 1, pubCoin, fModulusV2).getValue());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -5130,6 +5130,31 @@ CWallet::CreateZerocoinMintTransaction(CScript pubCoin, int64_t nValue, CWalletT
  * @param strFailReason
  * @return
  */
+libzerocoin::AccumulatorWitness CWallet::GetZerocoinWitness(int maxHeight, libzerocoin::CoinDenomination denomination, int id,
+                                                            const CBigNum& pubCoin, bool fModulusV2) {
+    AssertLockHeld(cs_main);
+
+    CZerocoinState *zerocoinState = CZerocoinState::GetZerocoinState();
+    if (!fFileBacked)
+        return zerocoinState->GetWitnessForSpend(&chainActive, maxHeight, denomination, id, pubCoin, fModulusV2);
+
+    CWalletDB walletdb(strWalletFile);
+    CZerocoinWitnessEntry entry;
+    if (!walletdb.ReadZerocoinWitness(pubCoin, fModulusV2, entry) || entry.denomination != denomination || entry.id != id) {
+        entry.SetNull();
+        entry.denomination = denomination;
+        entry.id = id;
+    }
+
+    uint256 cachedBlockHash = entry.blockHash;
+    libzerocoin::AccumulatorWitness witness = zerocoinState->GetWitnessForSpend(&chainActive, maxHeight, denomination, id,
+                                                                                pubCoin, fModulusV2, entry.witnessValue, entry.blockHash);
+    if (entry.blockHash != cachedBlockHash)
+        walletdb.WriteZerocoinWitness(pubCoin, fModulusV2, entry);
+
+    return witness;
+}
+
 bool CWallet::CreateZerocoinSpendTransaction(std::string &thirdPartyaddress, int64_t nValue, libzerocoin::CoinDenomination denomination,
                                              CWalletTx &wtxNew, CReserveKey &reservekey, CBigNum &coinSerial,
                                              uint256 &txHash, CBigNum &zcSelectedValue, bool &zcSelectedIsUsed,
@@ -5243,11 +5268,10 @@ bool CWallet::CreateZerocoinSpendTransaction(std::string &thirdPartyaddress, int
 
             // 4. Get witness from the index
             libzerocoin::AccumulatorWitness witness =
-                    zerocoinState->GetWitnessForSpend(&chainActive,
-                                                      chainActive.Height()-(ZC_MINT_CONFIRMATIONS-1),
-                                                      denomination, coinId,
-                                                      coinToUse.value,
-                                                      fModulusV2);
+                    GetZerocoinWitness(chainActive.Height()-(ZC_MINT_CONFIRMATIONS-1),
+                                       denomination, coinId,
+                                       coinToUse.value,
+                                       fModulusV2);
 
             int serializedId = coinId + (fModulusV2 ? ZC_MODULUS_V2_BASE_ID : 0);
 
@@ -5789,11 +5813,10 @@ bool CWallet::CreateMultipleZerocoinSpendTransaction(std::string &thirdPartyaddr
                 }
                  // 4. Get witness for the accumulator and selected coin
                 libzerocoin::AccumulatorWitness witness =
-                        zerocoinState->GetWitnessForSpend(&chainActive,
-                                                          chainActive.Height()-(ZC_MINT_CONFIRMATIONS-1),
-                                                          denomination, coinId,
-                                                          coinToUse.value,
-                                                          fModulusV2);
+                        GetZerocoinWitness(chainActive.Height()-(ZC_MINT_CONFIRMATIONS-1),
+                                           denomination, coinId,
+                                           coinToUse.value,
+                                           fModulusV2);
 
                 // Generate TxIn info
                 int serializedId = coinId + (fModulusV2 ? ZC_MODULUS_V2_BASE_ID : 0);
@@ -5879,13 +5902,11 @@ bool CWallet::CreateMultipleZerocoinSpendTransaction(std::string &thirdPartyaddr
                 CZerocoinEntry coinToUse = tempStorage.coinToUse;
 
                  //have to recreate coin witness as it can't be stored in an object, hence we can't store it in tempStorage..
-                CZerocoinState *zerocoinState = CZerocoinState::GetZerocoinState();
                 libzerocoin::AccumulatorWitness witness =
-                zerocoinState->GetWitnessForSpend(&chainActive,
-                                                  chainActive.Height()-(ZC_MINT_CONFIRMATIONS-1),
-                                                  tempStorage.denomination, tempStorage.coinId,
-                                                  coinToUse.value,
-                                                  fModulusV2);
+                GetZerocoinWitness(chainActive.Height()-(ZC_MINT_CONFIRMATIONS-1),
+                                   tempStorage.denomination, tempStorage.coinId,
+                                   coinToUse.value,
+                                   fModulusV2);
 
                 // Recreate CoinSpend object
                  libzerocoin::CoinSpend spend(zcParams,
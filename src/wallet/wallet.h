@@ -975,6 +975,9 @@ public:
                                        CWalletTx& wtxNew, CReserveKey& reservekey, int64_t& nFeeRet, std::string& strFailReason, bool isSigmaMint, const CCoinControl *coinControl=NULL);
     bool CreateZerocoinSpendTransaction(std::string& thirdPartyaddress, int64_t nValue, libzerocoin::CoinDenomination denomination,
                                         CWalletTx& wtxNew, CReserveKey& reservekey, CBigNum& coinSerial, uint256& txHash, CBigNum& zcSelectedValue, bool& zcSelectedIsUsed,  std::string& strFailReason, bool forceUsed = false);
+    // Accumulator witness for spending a zerocoin mint, continued from the one cached in the wallet database
+    libzerocoin::AccumulatorWitness GetZerocoinWitness(int maxHeight, libzerocoin::CoinDenomination denomination, int id,
+                                                       const CBigNum& pubCoin, bool fModulusV2);
 
     bool CreateSigmaSpendTransaction(
         std::string& thirdPartyaddress,
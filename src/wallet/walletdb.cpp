@@ -299,6 +299,14 @@ CWalletDB::ReadZerocoinAccumulator(libzerocoin::Accumulator &accumulator, libzer
 //    return Erase(std::make_tuple(string("zcaccumulator"), (unsigned int) denomination, pubcoinid), accumulator);
 //}
 
+bool CWalletDB::WriteZerocoinWitness(const Bignum& pub, bool fModulusV2, const CZerocoinWitnessEntry& witness) {
+    return Write(std::make_tuple(std::string("zcwitness"), pub, fModulusV2), witness);
+}
+
+bool CWalletDB::ReadZerocoinWitness(const Bignum& pub, bool fModulusV2, CZerocoinWitnessEntry& witness) {
+    return Read(std::make_tuple(std::string("zcwitness"), pub, fModulusV2), witness);
+}
+
 bool CWalletDB::WriteZerocoinEntry(const CZerocoinEntry &zerocoin) {
     return Write(make_pair(string("zerocoin"), zerocoin.value), zerocoin, true);
 }
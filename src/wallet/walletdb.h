@@ -250,6 +250,8 @@ public:
     bool HasCoinSpendSerialEntry(const secp_primitives::Scalar& serial);
     bool EraseCoinSpendSerialEntry(const CZerocoinSpendEntry& zerocoinSpend);
     bool EraseCoinSpendSerialEntry(const CSigmaSpendEntry& zerocoinSpend);
+    bool WriteZerocoinWitness(const Bignum& pub, bool fModulusV2, const CZerocoinWitnessEntry& witness);
+    bool ReadZerocoinWitness(const Bignum& pub, bool fModulusV2, CZerocoinWitnessEntry& witness);
     bool WriteZerocoinAccumulator(libzerocoin::Accumulator accumulator, libzerocoin::CoinDenomination denomination, int pubcoinid);
     bool ReadZerocoinAccumulator(libzerocoin::Accumulator& accumulator, libzerocoin::CoinDenomination denomination, int pubcoinid);
     // bool EraseZerocoinAccumulator(libzerocoin::Accumulator& accumulator, libzerocoin::CoinDenomination denomination, int pubcoinid);
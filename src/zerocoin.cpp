@@ -11,6 +11,7 @@
 #include "tnode-payments.h"
 #include "tnode-sync.h"
 #include "sigma/remint.h"
+#include "spendcache.h"
 
 #include <atomic>
 #include <sstream>
@@ -35,6 +36,24 @@ libzerocoin::Params *ZCParamsV2 = new libzerocoin::Params(bnTrustedModulusV2, bn
 
 static CZerocoinState zerocoinState;
 
+// Verify a spend against an accumulator. Spends accepted to the mempool are remembered in the spend
+// proof cache, so they are not verified again when their block is connected
+static bool VerifyZerocoinSpend(const libzerocoin::CoinSpend &spend, const uint256 &spendHash,
+        const libzerocoin::Accumulator &accumulator, const libzerocoin::SpendMetaData &metadata, bool fCacheResult) {
+    CHashWriter cacheHasher = SpendCacheHasher();
+    cacheHasher << spendHash << accumulator << metadata;
+    uint256 cacheEntry = cacheHasher.GetHash();
+    if (IsSpendProofCached(cacheEntry))
+        return true;
+
+    if (!spend.Verify(accumulator, metadata))
+        return false;
+
+    if (fCacheResult)
+        AddSpendProofToCache(cacheEntry);
+    return true;
+}
+
 static bool CheckZerocoinSpendSerial(CValidationState &state, const Consensus::Params &params, CZerocoinTxInfo *zerocoinTxInfo, libzerocoin::CoinDenomination denomination, const CBigNum &serial, int nHeight, bool fConnectTip) {
     if (nHeight > params.nCheckBugFixedAtBlock) {
         // check for zerocoin transaction in this block as well
@@ -364,6 +383,12 @@ bool CheckSpendZcoinTransaction(const CTransaction &tx,
 
         libzerocoin::SpendMetaData newMetadata(txin.nSequence, txHashForMetadata);
 
+        // the accumulator doesn't carry its modulus, it is part of the spend for the cache
+        CHashWriter spendHasher(SER_GETHASH, 0);
+        spendHasher << *spend << fModulusV2;
+        uint256 spendHash = spendHasher.GetHash();
+        bool fCacheResult = nHeight == INT_MAX && !isVerifyDB;
+
         CZerocoinState::CoinGroupInfo coinGroup;
         if (!zerocoinState.GetCoinGroupInfo(targetDenominations[vinIndex], pubcoinId, coinGroup))
             return state.DoS(100, false, NO_MINT_ZEROCOIN, "CheckSpendZcoinTransaction: Error: no coins were minted with such parameters");
@@ -386,18 +411,19 @@ bool CheckSpendZcoinTransaction(const CTransaction &tx,
 				index = index->pprev;
 		}
 
-        decltype(&CBlockIndex::accumulatorChanges) accChanges = fModulusV2 == fModulusV2InIndex ?
-                    &CBlockIndex::accumulatorChanges : &CBlockIndex::alternativeAccumulatorChanges;
+        decltype(&CBlockPrivacyData::accumulatorChanges) accChanges = fModulusV2 == fModulusV2InIndex ?
+                    &CBlockPrivacyData::accumulatorChanges : &CBlockPrivacyData::alternativeAccumulatorChanges;
 
         // Enumerate all the accumulator changes seen in the blockchain starting with the latest block
         // In most cases the latest accumulator value will be used for verification
         do {
-            if ((index->*accChanges).count(denominationAndId) > 0) {
+            const map<pair<int,int>, pair<CBigNum,int>> &indexAccChanges = index->GetPrivacyData().*accChanges;
+            if (indexAccChanges.count(denominationAndId) > 0) {
                 libzerocoin::Accumulator accumulator(zcParams,
-                                                     (index->*accChanges)[denominationAndId].first,
+                                                     indexAccChanges.at(denominationAndId).first,
                                                      targetDenominations[vinIndex]);
                 LogPrintf("CheckSpendZcoinTransaction: accumulator=%s\n", accumulator.getValue().ToString().substr(0,15));
-                passVerify = spend->Verify(accumulator, newMetadata);
+                passVerify = VerifyZerocoinSpend(*spend, spendHash, accumulator, newMetadata, fCacheResult);
             }
 
             // if spend has block hash we don't need to look further
@@ -413,14 +439,17 @@ bool CheckSpendZcoinTransaction(const CTransaction &tx,
         if (!passVerify && spendVersion == ZEROCOIN_TX_VERSION_1) {
             // Build vector of coins sorted by the time of mint
             index = coinGroup.lastBlock;
-            vector<CBigNum> pubCoins = index->mintedPubCoins[denominationAndId];
+            vector<CBigNum> pubCoins;
+            if (index->GetPrivacyData().mintedPubCoins.count(denominationAndId) > 0)
+                pubCoins = index->GetPrivacyData().mintedPubCoins.at(denominationAndId);
             if (index != coinGroup.firstBlock) {
                 do {
                     index = index->pprev;
-                    if (index->mintedPubCoins.count(denominationAndId) > 0)
+                    const map<pair<int,int>, vector<CBigNum>> &indexMints = index->GetPrivacyData().mintedPubCoins;
+                    if (indexMints.count(denominationAndId) > 0)
                         pubCoins.insert(pubCoins.begin(),
-                                        index->mintedPubCoins[denominationAndId].cbegin(),
-                                        index->mintedPubCoins[denominationAndId].cend());
+                                        indexMints.at(denominationAndId).cbegin(),
+                                        indexMints.at(denominationAndId).cend());
                 } while (index != coinGroup.firstBlock);
             }
 
@@ -428,7 +457,7 @@ bool CheckSpendZcoinTransaction(const CTransaction &tx,
             BOOST_FOREACH(const CBigNum &pubCoin, pubCoins) {
                 accumulator += libzerocoin::PublicCoin(zcParams, pubCoin, (libzerocoin::CoinDenomination)targetDenominations[vinIndex]);
                 LogPrintf("CheckSpendZcoinTransaction: accumulator=%s\n", accumulator.getValue().ToString().substr(0,15));
-                if ((passVerify = spend->Verify(accumulator, newMetadata)) == true)
+                if ((passVerify = VerifyZerocoinSpend(*spend, spendHash, accumulator, newMetadata, fCacheResult)) == true)
                     break;
             }
 
@@ -439,7 +468,7 @@ bool CheckSpendZcoinTransaction(const CTransaction &tx,
                 BOOST_REVERSE_FOREACH(const CBigNum &pubCoin, pubCoins) {
                     accumulator += libzerocoin::PublicCoin(zcParams, pubCoin, (libzerocoin::CoinDenomination)targetDenominations[vinIndex]);
                     LogPrintf("CheckSpendZcoinTransaction: accumulatorRev=%s\n", accumulator.getValue().ToString().substr(0,15));
-                    if ((passVerify = spend->Verify(accumulator, newMetadata)) == true)
+                    if ((passVerify = VerifyZerocoinSpend(*spend, spendHash, accumulator, newMetadata, fCacheResult)) == true)
                         break;
                 }
             }
@@ -811,10 +840,13 @@ bool ConnectBlockZC(CValidationState &state, const CChainParams &chainParams, CB
 
 	    if (!fJustCheck) {
             // clear the state
-			pindexNew->spentSerials.clear();
-            pindexNew->mintedPubCoins.clear();
-            pindexNew->accumulatorChanges.clear();
-            pindexNew->alternativeAccumulatorChanges.clear();
+            if (pindexNew->HasPrivacyData()) {
+                CBlockPrivacyData &privacyData = pindexNew->GetPrivacyDataForUpdate();
+                privacyData.spentSerials.clear();
+                privacyData.mintedPubCoins.clear();
+                privacyData.accumulatorChanges.clear();
+                privacyData.alternativeAccumulatorChanges.clear();
+            }
         }
 
         if (pindexNew->nHeight > chainParams.GetConsensus().nCheckBugFixedAtBlock) {
@@ -823,7 +855,7 @@ bool ConnectBlockZC(CValidationState &state, const CChainParams &chainParams, CB
                     return false;
 
                 if (!fJustCheck) {
-                    pindexNew->spentSerials.insert(serial.first);
+                    pindexNew->GetPrivacyDataForUpdate().spentSerials.insert(serial.first);
                     zerocoinState.AddSpend(serial.first);
                 }
 
@@ -848,7 +880,8 @@ bool ConnectBlockZC(CValidationState &state, const CChainParams &chainParams, CB
             LogPrintf("ConnectTipZC: mint added denomination=%d, id=%d\n", denomination, mintId);
             pair<int,int> denomAndId = make_pair(denomination, mintId);
 
-            pindexNew->mintedPubCoins[denomAndId].push_back(mint.second);
+            CBlockPrivacyData &privacyData = pindexNew->GetPrivacyDataForUpdate();
+            privacyData.mintedPubCoins[denomAndId].push_back(mint.second);
 
             CZerocoinState::CoinGroupInfo coinGroupInfo;
             zerocoinState.GetCoinGroupInfo(denomination, mintId, coinGroupInfo);
@@ -859,16 +892,16 @@ bool ConnectBlockZC(CValidationState &state, const CChainParams &chainParams, CB
                                                  (libzerocoin::CoinDenomination)denomination);
             accumulator += pubCoin;
 
-            if (pindexNew->accumulatorChanges.count(denomAndId) > 0) {
-                pair<CBigNum,int> &accChange = pindexNew->accumulatorChanges[denomAndId];
+            if (privacyData.accumulatorChanges.count(denomAndId) > 0) {
+                pair<CBigNum,int> &accChange = privacyData.accumulatorChanges[denomAndId];
                 accChange.first = accumulator.getValue();
                 accChange.second++;
             }
             else {
-                pindexNew->accumulatorChanges[denomAndId] = make_pair(accumulator.getValue(), 1);
+                privacyData.accumulatorChanges[denomAndId] = make_pair(accumulator.getValue(), 1);
             }
             // invalidate alternative accumulator value for this denomination and id
-            pindexNew->alternativeAccumulatorChanges.erase(denomAndId);
+            privacyData.alternativeAccumulatorChanges.erase(denomAndId);
         }
     }
     else if (!fJustCheck) {
@@ -890,11 +923,16 @@ int ZerocoinGetNHeight(const CBlockHeader &block) {
 }
 
 
-bool ZerocoinBuildStateFromIndex(CChain *chain, set<CBlockIndex *> &changes) {
+bool ZerocoinBuildStateFromIndex(CChain *chain, set<CBlockIndex *> &changes, CBlockIndex *pindexSnapshot) {
     auto params = Params().GetConsensus();
 
-    zerocoinState.Reset();
-    for (CBlockIndex *blockIndex = chain->Genesis(); blockIndex; blockIndex=chain->Next(blockIndex))
+    CBlockIndex *blockIndex = chain->Genesis();
+    if (pindexSnapshot)
+        blockIndex = chain->Next(pindexSnapshot);
+    else
+        zerocoinState.Reset();
+
+    for (; blockIndex; blockIndex=chain->Next(blockIndex))
         zerocoinState.AddBlock(blockIndex, params);
 
     changes = zerocoinState.RecalculateAccumulators(chain);
@@ -963,7 +1001,7 @@ int CZerocoinState::AddMint(CBlockIndex *index, int denomination, const CBigNum
             coinGroup.firstBlock = coinGroup.lastBlock = index;
         }
         else {
-            previousAccValue = coinGroup.lastBlock->accumulatorChanges[make_pair(denomination,mintId)].first;
+            previousAccValue = coinGroup.lastBlock->GetPrivacyData().accumulatorChanges.at(make_pair(denomination,mintId)).first;
             coinGroup.lastBlock = index;
         }
     }
@@ -988,7 +1026,7 @@ void CZerocoinState::AddSpend(const CBigNum &serial) {
 }
 
 void CZerocoinState::AddBlock(CBlockIndex *index, const Consensus::Params &params) {
-    BOOST_FOREACH(const PAIRTYPE(PAIRTYPE(int,int), PAIRTYPE(CBigNum,int)) &accUpdate, index->accumulatorChanges)
+    BOOST_FOREACH(const PAIRTYPE(PAIRTYPE(int,int), PAIRTYPE(CBigNum,int)) &accUpdate, index->GetPrivacyData().accumulatorChanges)
     {
         CoinGroupInfo   &coinGroup = coinGroups[accUpdate.first];
 
@@ -998,7 +1036,7 @@ void CZerocoinState::AddBlock(CBlockIndex *index, const Consensus::Params &param
         coinGroup.nCoins += accUpdate.second.second;
     }
 
-    BOOST_FOREACH(const PAIRTYPE(PAIRTYPE(int,int),vector<CBigNum>) &pubCoins, index->mintedPubCoins) {
+    BOOST_FOREACH(const PAIRTYPE(PAIRTYPE(int,int),vector<CBigNum>) &pubCoins, index->GetPrivacyData().mintedPubCoins) {
         latestCoinIds[pubCoins.first.first] = pubCoins.first.second;
         BOOST_FOREACH(const CBigNum &coin, pubCoins.second) {
             CMintedCoinInfo coinInfo;
@@ -1010,7 +1048,7 @@ void CZerocoinState::AddBlock(CBlockIndex *index, const Consensus::Params &param
     }
 
     if (index->nHeight > params.nCheckBugFixedAtBlock) {
-        BOOST_FOREACH(const CBigNum &serial, index->spentSerials) {
+        BOOST_FOREACH(const CBigNum &serial, index->GetPrivacyData().spentSerials) {
             usedCoinSerials.insert(serial);
         }
     }
@@ -1018,7 +1056,7 @@ void CZerocoinState::AddBlock(CBlockIndex *index, const Consensus::Params &param
 
 void CZerocoinState::RemoveBlock(CBlockIndex *index) {
     // roll back accumulator updates
-    BOOST_FOREACH(const PAIRTYPE(PAIRTYPE(int,int), PAIRTYPE(CBigNum,int)) &accUpdate, index->accumulatorChanges)
+    BOOST_FOREACH(const PAIRTYPE(PAIRTYPE(int,int), PAIRTYPE(CBigNum,int)) &accUpdate, index->GetPrivacyData().accumulatorChanges)
     {
         CoinGroupInfo   &coinGroup = coinGroups[accUpdate.first];
         int  nMintsToForget = accUpdate.second.second;
@@ -1036,12 +1074,12 @@ void CZerocoinState::RemoveBlock(CBlockIndex *index) {
             do {
                 assert(coinGroup.lastBlock != coinGroup.firstBlock);
                 coinGroup.lastBlock = coinGroup.lastBlock->pprev;
-            } while (coinGroup.lastBlock->accumulatorChanges.count(accUpdate.first) == 0);
+            } while (coinGroup.lastBlock->GetPrivacyData().accumulatorChanges.count(accUpdate.first) == 0);
         }
     }
 
     // roll back mints
-    BOOST_FOREACH(const PAIRTYPE(PAIRTYPE(int,int),vector<CBigNum>) &pubCoins, index->mintedPubCoins) {
+    BOOST_FOREACH(const PAIRTYPE(PAIRTYPE(int,int),vector<CBigNum>) &pubCoins, index->GetPrivacyData().mintedPubCoins) {
         BOOST_FOREACH(const CBigNum &coin, pubCoins.second) {
             auto coins = mintedPubCoins.equal_range(coin);
             auto coinIt = find_if(coins.first, coins.second, [=](const decltype(mintedPubCoins)::value_type &v) {
@@ -1054,7 +1092,7 @@ void CZerocoinState::RemoveBlock(CBlockIndex *index) {
     }
 
     // roll back spends
-    BOOST_FOREACH(const CBigNum &serial, index->spentSerials) {
+    BOOST_FOREACH(const CBigNum &serial, index->GetPrivacyData().spentSerials) {
         usedCoinSerials.erase(serial);
     }
 }
@@ -1087,33 +1125,33 @@ int CZerocoinState::GetAccumulatorValueForSpend(CChain *chain, int maxHeight, in
     CoinGroupInfo coinGroup = coinGroups[denomAndId];
     CBlockIndex *lastBlock = coinGroup.lastBlock;
 
-    assert(lastBlock->accumulatorChanges.count(denomAndId) > 0);
-    assert(coinGroup.firstBlock->accumulatorChanges.count(denomAndId) > 0);
+    assert(lastBlock->GetPrivacyData().accumulatorChanges.count(denomAndId) > 0);
+    assert(coinGroup.firstBlock->GetPrivacyData().accumulatorChanges.count(denomAndId) > 0);
 
     // is native modulus for denomination and id v2?
     bool nativeModulusIsV2 = IsZerocoinTxV2((libzerocoin::CoinDenomination)denomination, Params().GetConsensus(), id);
     // field in the block index structure for accesing accumulator changes
-    decltype(&CBlockIndex::accumulatorChanges) accChangeField;
+    decltype(&CBlockPrivacyData::accumulatorChanges) accChangeField;
     if (nativeModulusIsV2 != useModulusV2) {
         CalculateAlternativeModulusAccumulatorValues(chain, denomination, id);
-        accChangeField = &CBlockIndex::alternativeAccumulatorChanges;
+        accChangeField = &CBlockPrivacyData::alternativeAccumulatorChanges;
     }
     else {
-        accChangeField = &CBlockIndex::accumulatorChanges;
+        accChangeField = &CBlockPrivacyData::accumulatorChanges;
     }
 
     int numberOfCoins = 0;
     for (;;) {
-        map<pair<int,int>, pair<CBigNum,int>> &accumulatorChanges = lastBlock->*accChangeField;
+        const map<pair<int,int>, pair<CBigNum,int>> &accumulatorChanges = lastBlock->GetPrivacyData().*accChangeField;
         if (accumulatorChanges.count(denomAndId) > 0) {
             if (lastBlock->nHeight <= maxHeight) {
                 if (numberOfCoins == 0) {
                     // latest block satisfying given conditions
                     // remember accumulator value and block hash
-                    accumulator = accumulatorChanges[denomAndId].first;
+                    accumulator = accumulatorChanges.at(denomAndId).first;
                     blockHash = lastBlock->GetBlockHash();
                 }
-                numberOfCoins += accumulatorChanges[denomAndId].second;
+                numberOfCoins += accumulatorChanges.at(denomAndId).second;
             }
         }
 
@@ -1128,6 +1166,14 @@ int CZerocoinState::GetAccumulatorValueForSpend(CChain *chain, int maxHeight, in
 
 libzerocoin::AccumulatorWitness CZerocoinState::GetWitnessForSpend(CChain *chain, int maxHeight, int denomination,
                                                                    int id, const CBigNum &pubCoin, bool useModulusV2) {
+    CBigNum witnessValue;
+    uint256 witnessBlockHash;
+    return GetWitnessForSpend(chain, maxHeight, denomination, id, pubCoin, useModulusV2, witnessValue, witnessBlockHash);
+}
+
+libzerocoin::AccumulatorWitness CZerocoinState::GetWitnessForSpend(CChain *chain, int maxHeight, int denomination,
+                                                                   int id, const CBigNum &pubCoin, bool useModulusV2,
+                                                                   CBigNum &witnessValue, uint256 &witnessBlockHash) {
 
     libzerocoin::CoinDenomination d = (libzerocoin::CoinDenomination)denomination;
     pair<int, int> denomAndId = pair<int, int>(denomination, id);
@@ -1142,43 +1188,63 @@ libzerocoin::AccumulatorWitness CZerocoinState::GetWitnessForSpend(CChain *chain
     assert(coinId == id);
 
     libzerocoin::Params *zcParams = useModulusV2 ? ZCParamsV2 : ZCParams;
-    bool nativeModulusIsV2 = IsZerocoinTxV2((libzerocoin::CoinDenomination)denomination, Params().GetConsensus(), id);
-    decltype(&CBlockIndex::accumulatorChanges) accChangeField;
-    if (nativeModulusIsV2 != useModulusV2) {
-        CalculateAlternativeModulusAccumulatorValues(chain, denomination, id);
-        accChangeField = &CBlockIndex::alternativeAccumulatorChanges;
-    }
-    else {
-        accChangeField = &CBlockIndex::accumulatorChanges;
-    }
-
-    // Find accumulator value preceding mint operation
     CBlockIndex *mintBlock = (*chain)[mintHeight];
-    CBlockIndex *block = mintBlock;
+    CBlockIndex *block;
     libzerocoin::Accumulator accumulator(zcParams, d);
-    if (block != coinGroup.firstBlock) {
-        do {
-            block = block->pprev;
-        } while ((block->*accChangeField).count(denomAndId) == 0);
-        accumulator = libzerocoin::Accumulator(zcParams, (block->*accChangeField)[denomAndId].first, d);
+
+    // A witness value computed before includes the coins minted up to its block. It is extended with
+    // the later ones if that block is still on the chain and not above maxHeight
+    int witnessHeight = -1;
+    if (!witnessBlockHash.IsNull()) {
+        BlockMap::const_iterator it = mapBlockIndex.find(witnessBlockHash);
+        if (it != mapBlockIndex.end() && chain->Contains(it->second)
+                && it->second->nHeight >= mintHeight && it->second->nHeight <= maxHeight) {
+            witnessHeight = it->second->nHeight;
+            accumulator = libzerocoin::Accumulator(zcParams, witnessValue, d);
+        }
+    }
+
+    if (witnessHeight < 0) {
+        bool nativeModulusIsV2 = IsZerocoinTxV2((libzerocoin::CoinDenomination)denomination, Params().GetConsensus(), id);
+        decltype(&CBlockPrivacyData::accumulatorChanges) accChangeField;
+        if (nativeModulusIsV2 != useModulusV2) {
+            CalculateAlternativeModulusAccumulatorValues(chain, denomination, id);
+            accChangeField = &CBlockPrivacyData::alternativeAccumulatorChanges;
+        }
+        else {
+            accChangeField = &CBlockPrivacyData::accumulatorChanges;
+        }
+
+        // Find accumulator value preceding mint operation
+        block = mintBlock;
+        if (block != coinGroup.firstBlock) {
+            do {
+                block = block->pprev;
+            } while ((block->GetPrivacyData().*accChangeField).count(denomAndId) == 0);
+            accumulator = libzerocoin::Accumulator(zcParams, (block->GetPrivacyData().*accChangeField).at(denomAndId).first, d);
+        }
+        witnessHeight = mintHeight - 1;
     }
 
     // Now add to the accumulator every coin minted since that moment except pubCoin
     block = coinGroup.lastBlock;
     for (;;) {
-        if (block->nHeight <= maxHeight && block->mintedPubCoins.count(denomAndId) > 0) {
-            vector<CBigNum> &pubCoins = block->mintedPubCoins[denomAndId];
+        if (block->nHeight <= maxHeight && block->nHeight > witnessHeight && block->GetPrivacyData().mintedPubCoins.count(denomAndId) > 0) {
+            const vector<CBigNum> &pubCoins = block->GetPrivacyData().mintedPubCoins.at(denomAndId);
             for (const CBigNum &coin: pubCoins) {
                 if (block != mintBlock || coin != pubCoin)
                     accumulator += libzerocoin::PublicCoin(zcParams, coin, d);
             }
         }
-        if (block != mintBlock)
+        if (block != mintBlock && block->nHeight > witnessHeight + 1)
             block = block->pprev;
         else
             break;
     }
 
+    witnessValue = accumulator.getValue();
+    witnessBlockHash = (*chain)[std::min(maxHeight, chain->Height())]->GetBlockHash();
+
     return libzerocoin::AccumulatorWitness(zcParams, accumulator, libzerocoin::PublicCoin(zcParams, pubCoin, d));
 }
 
@@ -1210,18 +1276,19 @@ void CZerocoinState::CalculateAlternativeModulusAccumulatorValues(CChain *chain,
 
     CBlockIndex *block = coinGroup.firstBlock;
     for (;;) {
-        if (block->accumulatorChanges.count(denomAndId) > 0) {
-            if (block->alternativeAccumulatorChanges.count(denomAndId) > 0)
+        if (block->GetPrivacyData().accumulatorChanges.count(denomAndId) > 0) {
+            CBlockPrivacyData &privacyData = block->GetPrivacyDataForUpdate();
+            if (privacyData.alternativeAccumulatorChanges.count(denomAndId) > 0)
                 // already calculated, update accumulator with cached value
-                accumulator = libzerocoin::Accumulator(altParams, block->alternativeAccumulatorChanges[denomAndId].first, d);
+                accumulator = libzerocoin::Accumulator(altParams, privacyData.alternativeAccumulatorChanges[denomAndId].first, d);
             else {
                 // re-create accumulator changes with alternative params
-                assert(block->mintedPubCoins.count(denomAndId) > 0);
-                const vector<CBigNum> &mintedCoins = block->mintedPubCoins[denomAndId];
+                assert(privacyData.mintedPubCoins.count(denomAndId) > 0);
+                const vector<CBigNum> &mintedCoins = privacyData.mintedPubCoins[denomAndId];
                 BOOST_FOREACH(const CBigNum &c, mintedCoins) {
                     accumulator += libzerocoin::PublicCoin(altParams, c, d);
                 }
-                block->alternativeAccumulatorChanges[denomAndId] = make_pair(accumulator.getValue(), (int)mintedCoins.size());
+                privacyData.alternativeAccumulatorChanges[denomAndId] = make_pair(accumulator.getValue(), (int)mintedCoins.size());
             }
         }
 
@@ -1243,22 +1310,23 @@ bool CZerocoinState::TestValidity(CChain *chain) {
 
         CBlockIndex *block = coinGroup.second.firstBlock;
         for (;;) {
-            if (block->accumulatorChanges.count(coinGroup.first) > 0) {
-                if (block->mintedPubCoins.count(coinGroup.first) == 0) {
+            const CBlockPrivacyData &privacyData = block->GetPrivacyData();
+            if (privacyData.accumulatorChanges.count(coinGroup.first) > 0) {
+                if (privacyData.mintedPubCoins.count(coinGroup.first) == 0) {
                     fprintf(stderr, "  no minted coins\n");
                     return false;
                 }
 
-                BOOST_FOREACH(const CBigNum &pubCoin, block->mintedPubCoins[coinGroup.first]) {
+                BOOST_FOREACH(const CBigNum &pubCoin, privacyData.mintedPubCoins.at(coinGroup.first)) {
                     acc += libzerocoin::PublicCoin(zcParams, pubCoin, (libzerocoin::CoinDenomination)coinGroup.first.first);
                 }
 
-                if (acc.getValue() != block->accumulatorChanges[coinGroup.first].first) {
+                if (acc.getValue() != privacyData.accumulatorChanges.at(coinGroup.first).first) {
                     fprintf (stderr, "  accumulator value mismatch at height %d\n", block->nHeight);
                     return false;
                 }
 
-                if (block->accumulatorChanges[coinGroup.first].second != (int)block->mintedPubCoins[coinGroup.first].size()) {
+                if (privacyData.accumulatorChanges.at(coinGroup.first).second != (int)privacyData.mintedPubCoins.at(coinGroup.first).size()) {
                     fprintf(stderr, "  number of minted coins mismatch at height %d\n", block->nHeight);
                     return false;
                 }
@@ -1289,14 +1357,15 @@ set<CBlockIndex *> CZerocoinState::RecalculateAccumulators(CChain *chain) {
         // Try to calculate accumulator for the first batch of mints. If it doesn't match we need to recalculate the rest of it
         CBlockIndex *block = coinGroup.second.firstBlock;
         for (;;) {
-            if (block->accumulatorChanges.count(coinGroup.first) > 0) {
-                BOOST_FOREACH(const CBigNum &pubCoin, block->mintedPubCoins[coinGroup.first]) {
+            if (block->GetPrivacyData().accumulatorChanges.count(coinGroup.first) > 0) {
+                CBlockPrivacyData &privacyData = block->GetPrivacyDataForUpdate();
+                BOOST_FOREACH(const CBigNum &pubCoin, privacyData.mintedPubCoins[coinGroup.first]) {
                     acc += libzerocoin::PublicCoin(ZCParamsV2, pubCoin, (libzerocoin::CoinDenomination)coinGroup.first.first);
                 }
 
                 // First block case is special: do the check
                 if (block == coinGroup.second.firstBlock) {
-                    if (acc.getValue() != block->accumulatorChanges[coinGroup.first].first)
+                    if (acc.getValue() != privacyData.accumulatorChanges[coinGroup.first].first)
                         // recalculation is needed
                         LogPrintf("ZerocoinState: accumulator recalculation for denomination=%d, id=%d\n", coinGroup.first.first, coinGroup.first.second);
                     else
@@ -1304,7 +1373,7 @@ set<CBlockIndex *> CZerocoinState::RecalculateAccumulators(CChain *chain) {
                         break;
                 }
 
-                block->accumulatorChanges[coinGroup.first] = make_pair(acc.getValue(), (int)block->mintedPubCoins[coinGroup.first].size());
+                privacyData.accumulatorChanges[coinGroup.first] = make_pair(acc.getValue(), (int)privacyData.mintedPubCoins[coinGroup.first].size());
                 changes.insert(block);
             }
 
@@ -1384,6 +1453,74 @@ void CZerocoinState::Reset() {
     mempoolCoinSerials.clear();
 }
 
+void WriteStateSnapshotBlock(CDataStream &s, const CBlockIndex *index) {
+    s << (index ? index->GetBlockHash() : uint256());
+}
+
+bool ReadStateSnapshotBlock(CDataStream &s, CBlockIndex *&index) {
+    uint256 hash;
+    s >> hash;
+    BlockMap::const_iterator it = mapBlockIndex.find(hash);
+    if (it == mapBlockIndex.end() || !chainActive.Contains(it->second))
+        return false;
+    index = it->second;
+    return true;
+}
+
+void CZerocoinState::WriteSnapshot(CDataStream &s) const {
+    WriteCompactSize(s, coinGroups.size());
+    BOOST_FOREACH(const PAIRTYPE(PAIRTYPE(int,int), CoinGroupInfo) &coinGroup, coinGroups) {
+        s << coinGroup.first.first << coinGroup.first.second;
+        WriteStateSnapshotBlock(s, coinGroup.second.firstBlock);
+        WriteStateSnapshotBlock(s, coinGroup.second.lastBlock);
+        s << coinGroup.second.nCoins;
+    }
+
+    WriteCompactSize(s, mintedPubCoins.size());
+    for (const auto &coin : mintedPubCoins)
+        s << coin.first << coin.second.denomination << coin.second.id << coin.second.nHeight;
+
+    WriteCompactSize(s, usedCoinSerials.size());
+    for (const CBigNum &serial : usedCoinSerials)
+        s << serial;
+
+    s << latestCoinIds;
+}
+
+bool CZerocoinState::ReadSnapshot(CDataStream &s) {
+    Reset();
+
+    for (uint64_t n = ReadCompactSize(s); n > 0; n--) {
+        pair<int,int> denomAndId;
+        CoinGroupInfo coinGroup;
+        s >> denomAndId.first >> denomAndId.second;
+        if (!ReadStateSnapshotBlock(s, coinGroup.firstBlock) || !ReadStateSnapshotBlock(s, coinGroup.lastBlock))
+            return false;
+        s >> coinGroup.nCoins;
+        coinGroups[denomAndId] = coinGroup;
+    }
+
+    uint64_t nMints = ReadCompactSize(s);
+    mintedPubCoins.reserve(nMints);
+    for (; nMints > 0; nMints--) {
+        CBigNum pubCoin;
+        CMintedCoinInfo coinInfo;
+        s >> pubCoin >> coinInfo.denomination >> coinInfo.id >> coinInfo.nHeight;
+        mintedPubCoins.insert(make_pair(pubCoin, coinInfo));
+    }
+
+    uint64_t nSerials = ReadCompactSize(s);
+    usedCoinSerials.reserve(nSerials);
+    for (; nSerials > 0; nSerials--) {
+        CBigNum serial;
+        s >> serial;
+        usedCoinSerials.insert(serial);
+    }
+
+    s >> latestCoinIds;
+    return true;
+}
+
 CZerocoinState *CZerocoinState::GetZerocoinState() {
     return &zerocoinState;
 }
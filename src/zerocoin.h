@@ -64,15 +64,22 @@ bool ConnectBlockZC(CValidationState &state, const CChainParams &chainparams, CB
 
 int ZerocoinGetNHeight(const CBlockHeader &block);
 
-bool ZerocoinBuildStateFromIndex(CChain *chain, set<CBlockIndex *> &changes);
+// Build the state from the index. With pindexSnapshot, the state has been read from a snapshot taken
+// at that block and only the blocks after it are added
+bool ZerocoinBuildStateFromIndex(CChain *chain, set<CBlockIndex *> &changes, CBlockIndex *pindexSnapshot = NULL);
 
 CBigNum ZerocoinGetSpendSerialNumber(const CTransaction &tx, const CTxIn &txin);
 
+// Blocks of the zerocoin and sigma state snapshots are written as hashes. Reading fails for blocks not
+// in the active chain
+void WriteStateSnapshotBlock(CDataStream &s, const CBlockIndex *index);
+bool ReadStateSnapshotBlock(CDataStream &s, CBlockIndex *&index);
+
 /*
  * State of minted/spent coins as extracted from the index
  */
 class CZerocoinState {
-friend bool ZerocoinBuildStateFromIndex(CChain *, set<CBlockIndex *> &);
+friend bool ZerocoinBuildStateFromIndex(CChain *, set<CBlockIndex *> &, CBlockIndex *);
 public:
     // First and last block where mint (and hence accumulator update) with given denomination and id was seen
     struct CoinGroupInfo {
@@ -141,6 +148,10 @@ public:
 
     // Get witness
     libzerocoin::AccumulatorWitness GetWitnessForSpend(CChain *chain, int maxHeight, int denomination, int id, const CBigNum &pubCoin, bool useModulusV2);
+    // Get witness starting from witnessValue, computed by an earlier call for the coins minted up to witnessBlockHash.
+    // A null hash or a block no longer usable computes it from the index. Both are set for the returned witness
+    libzerocoin::AccumulatorWitness GetWitnessForSpend(CChain *chain, int maxHeight, int denomination, int id, const CBigNum &pubCoin, bool useModulusV2,
+                                                       CBigNum &witnessValue, uint256 &witnessBlockHash);
 
     // Return height of mint transaction and id of minted coin
     int GetMintedCoinHeightAndId(const CBigNum &pubCoin, int denomination, int &id);
@@ -151,6 +162,11 @@ public:
     // Reset to initial values
     void Reset();
 
+    // Write the state of the blockchain part (not the mempool) to a snapshot
+    void WriteSnapshot(CDataStream &s) const;
+    // Read the state from a snapshot. Returns false if its blocks aren't in the active chain
+    bool ReadSnapshot(CDataStream &s);
+
     // Test function
     bool TestValidity(CChain *chain);
 